@@ -0,0 +1,77 @@
+/**
+ * Bench.hpp - Helpers for the benchmark programs.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_BENCH_BENCH_HPP
+#define SE_BENCH_BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace Bench
+{
+    /**
+     * Time FUNC, keeping the fastest of RUNS runs.
+     *
+     * @param runs Number of times to run FUNC.
+     * @param func Function to time.
+     * @return Seconds taken by the fastest run.
+     */
+    template<class F>
+    double best_of(int runs, F &&func)
+    {
+        auto best = std::numeric_limits<double>::infinity();
+        for (int i = 0; i < runs; ++i)
+        {
+            auto const start = std::chrono::steady_clock::now();
+            func();
+            std::chrono::duration<double> const took{
+                std::chrono::steady_clock::now() - start};
+            best = std::min(best, took.count());
+        }
+        return best;
+    }
+
+    /** Compare values bit for bit, so -0 and 0 are told apart. */
+    template<class T>
+    bool same_bits(T const &a, T const &b)
+    {
+        return std::memcmp(&a, &b, sizeof(T)) == 0;
+    }
+
+    /** Print a timing result, as "NAME: N unit". */
+    inline void report(char const *name, double seconds)
+    {
+        if (seconds < 1e-3)
+        {
+            std::printf("%-24s %10.2f us\n", name, seconds * 1e6);
+        }
+        else if (seconds < 1.0)
+        {
+            std::printf("%-24s %10.2f ms\n", name, seconds * 1e3);
+        }
+        else
+        {
+            std::printf("%-24s %10.2f s\n", name, seconds);
+        }
+    }
+} // namespace Bench
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * RMFGen.hpp - Generate .rmf maps for the benchmarks.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_BENCH_RMFGEN_HPP
+#define SE_BENCH_RMFGEN_HPP
+
+#include <files/rmf/rmf.hpp>
+
+#include <string>
+
+namespace Bench
+{
+    /**
+     * Make an axis-aligned cube, with its faces wound clockwise as
+     * Worldcraft stores them.
+     *
+     * @param x,y,z Lowest corner of the cube.
+     * @param size Length of each side.
+     * @param texture Texture used on every face.
+     */
+    inline RMF::Solid make_cube(
+        float x,
+        float y,
+        float z,
+        float size,
+        std::string const &texture)
+    {
+        float const lo[3]{x, y, z};
+        RMF::Solid solid{};
+        solid.visgroup_index = 0;
+        solid.color = {0, 200, 100};
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            for (int side = 0; side < 2; ++side)
+            {
+                // U and V span the face, with U x V pointing out of the cube.
+                int const u = (axis + 2 - side) % 3;
+                int const v = (axis + 1 + side) % 3;
+                float corner[3]{lo[0], lo[1], lo[2]};
+                corner[axis] += side * size;
+
+                RMF::Face face{};
+                face.texture_name = texture;
+                float texture_u[3]{};
+                float texture_v[3]{};
+                texture_u[u] = 1.0f;
+                texture_v[v] = -1.0f;
+                face.texture_u = {texture_u[0], texture_u[1], texture_u[2]};
+                face.texture_v = {texture_v[0], texture_v[1], texture_v[2]};
+                face.texture_x_shift = 0.0f;
+                face.texture_y_shift = 0.0f;
+                face.texture_rotation = 0.0f;
+                face.texture_x_scale = 1.0f;
+                face.texture_y_scale = 1.0f;
+
+                // Clockwise seen from outside: origin, +V, +U+V, +U.
+                float const steps[4][2]{
+                    {0.0f, 0.0f},
+                    {0.0f, size},
+                    {size, size},
+                    {size, 0.0f}
+                };
+                for (auto const &step : steps)
+                {
+                    float point[3]{corner[0], corner[1], corner[2]};
+                    point[u] += step[0];
+                    point[v] += step[1];
+                    face.vertices.push_back({point[0], point[1], point[2]});
+                }
+                for (int i = 0; i < 3; ++i)
+                {
+                    face.plane[i] = face.vertices[i];
+                }
+                solid.faces.push_back(std::move(face));
+            }
+        }
+        return solid;
+    }
+
+    /**
+     * Make a point entity with a few key/value pairs.
+     *
+     * @param n Number used to make the entity's values distinct.
+     */
+    inline RMF::Entity make_point_entity(int n)
+    {
+        RMF::Entity entity{};
+        entity.visgroup_index = 0;
+        entity.color = {220, 30, 220};
+        entity.classname = "light";
+        entity.flags = n % 4;
+        entity.kv_pairs = {
+            {"_light", "255 255 128 " + std::to_string(n % 300)},
+            {"style", std::to_string(n % 12)},
+            {"targetname", "light" + std::to_string(n)},
+        };
+        entity.position = {n * 8.0f, -n * 4.0f, 64.0f};
+        return entity;
+    }
+
+    /** Make an empty Worldcraft 2.2 map. */
+    inline RMF::RichMap make_rich_map()
+    {
+        RMF::RichMap map{};
+        map.version = 2.2f;
+        map.objects.visgroup_index = 0;
+        map.objects.color = {0, 0, 0};
+        map.worldspawn_name = "worldspawn";
+        map.worldspawn_properties = {
+            {"wad", "halflife.wad"},
+            {"mapversion", "220"},
+        };
+        map.active_camera = -1;
+        return map;
+    }
+} // namespace Bench
+
+#endif
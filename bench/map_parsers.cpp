@@ -0,0 +1,162 @@
+/**
+ * map_parsers.cpp - Compare the .map parsers.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Bench.hpp"
+
+#include <files/map/map.hpp>
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+using Bench::same_bits;
+
+static bool same_plane(MAP::Plane const &a, MAP::Plane const &b)
+{
+    return same_bits(a.a, b.a) && same_bits(a.b, b.b) && same_bits(a.c, b.c)
+        && a.miptex == b.miptex && same_bits(a.s, b.s)
+        && same_bits(a.t, b.t) && same_bits(a.offsets, b.offsets)
+        && same_bits(a.rotation, b.rotation) && same_bits(a.scale, b.scale);
+}
+
+/**
+ * Find the first difference between two maps.
+ *
+ * @return A description of the difference, or an empty string if the maps
+ *         are the same.
+ */
+static std::string compare(MAP::Map const &a, MAP::Map const &b)
+{
+    if (a.entities.size() != b.entities.size())
+    {
+        return "entity counts differ";
+    }
+    for (size_t e = 0; e < a.entities.size(); ++e)
+    {
+        auto const &ea = a.entities[e];
+        auto const &eb = b.entities[e];
+        auto const where = "entity " + std::to_string(e);
+        if (ea.properties != eb.properties)
+        {
+            return where + ": properties differ";
+        }
+        if (ea.brushes.size() != eb.brushes.size())
+        {
+            return where + ": brush counts differ";
+        }
+        for (size_t b = 0; b < ea.brushes.size(); ++b)
+        {
+            auto const &pa = ea.brushes[b].planes;
+            auto const &pb = eb.brushes[b].planes;
+            if (pa.size() != pb.size())
+            {
+                return where + " brush " + std::to_string(b)
+                     + ": plane counts differ";
+            }
+            for (size_t p = 0; p < pa.size(); ++p)
+            {
+                if (!same_plane(pa[p], pb[p]))
+                {
+                    return where + " brush " + std::to_string(b) + " plane "
+                         + std::to_string(p) + " differs";
+                }
+            }
+        }
+    }
+    return {};
+}
+
+/**
+ * Usage: bench-map-parsers FILE...
+ *
+ * Loads each file with every parser, checks they all give the same result,
+ * and reports how long each took. Exits with 1 if any results differ or a
+ * file fails to load.
+ */
+int main(int argc, char *argv[])
+{
+    constexpr int RUNS = 3;
+
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s FILE...\n", argv[0]);
+        return 2;
+    }
+
+    std::pair<char const *, MAP::Parser> const parsers[] = {
+        {"flex/bison", MAP::Parser::FLEX_BISON},
+        {"fast",       MAP::Parser::FAST      },
+        {"parallel",   MAP::Parser::PARALLEL  },
+    };
+
+    bool ok = true;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string const path{argv[i]};
+        std::printf("%s, best of %d:\n", path.c_str(), RUNS);
+        try
+        {
+            auto const expected = MAP::load(path, MAP::Parser::FLEX_BISON);
+            for (auto const &[name, parser_] : parsers)
+            {
+                // Structured bindings can't be captured in C++17.
+                auto const parser = parser_;
+                MAP::Map result{};
+                auto const seconds = Bench::best_of(
+                    RUNS,
+                    [&]() { result = MAP::load(path, parser); });
+                Bench::report(name, seconds);
+                auto const difference = compare(expected, result);
+                if (!difference.empty())
+                {
+                    std::printf("  %s differs: %s\n", name, difference.c_str());
+                    ok = false;
+                }
+            }
+
+            MAP::Map streamed{};
+            auto const seconds = Bench::best_of(
+                RUNS,
+                [&]()
+                {
+                    streamed.entities.clear();
+                    MAP::load_entities(
+                        path,
+                        [&streamed](MAP::Entity &&entity)
+                        { streamed.entities.push_back(std::move(entity)); });
+                });
+            Bench::report("load_entities", seconds);
+            auto const difference = compare(expected, streamed);
+            if (!difference.empty())
+            {
+                std::printf(
+                    "  load_entities differs: %s\n",
+                    difference.c_str());
+                ok = false;
+            }
+        }
+        catch (MAP::LoadError const &e)
+        {
+            std::printf("  failed to load: %s\n", e.what());
+            ok = false;
+        }
+    }
+    std::printf(ok ? "all parsers agree\n" : "parsers disagree\n");
+    return ok ? 0 : 1;
+}
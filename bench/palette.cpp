@@ -0,0 +1,163 @@
+/**
+ * palette.cpp - Benchmark for WAD palette expansion.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Bench.hpp"
+
+#include <files/wad/Palette.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+/** The per-pixel loop which palette_to_rgba() replaced. */
+static void reference_rgba(
+    uint8_t const *indices,
+    size_t count,
+    uint8_t const *palette,
+    size_t palette_size,
+    uint8_t *out)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto const index = indices[i];
+        for (size_t c = 0; c < 3; ++c)
+        {
+            out[4 * i + c] = index < palette_size ? palette[3 * index + c] : 0;
+        }
+        out[4 * i + 3] = 0xff;
+    }
+}
+
+/** The per-pixel loop which palette_to_rgb() replaced. */
+static void reference_rgb(
+    uint8_t const *indices,
+    size_t count,
+    uint8_t const *palette,
+    size_t palette_size,
+    uint8_t *out)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto const index = indices[i];
+        for (size_t c = 0; c < 3; ++c)
+        {
+            out[3 * i + c] = index < palette_size ? palette[3 * index + c] : 0;
+        }
+    }
+}
+
+/**
+ * Check the expansion against the reference loops for every size up to
+ * MAX_COUNT, with a short palette so out of range indices are covered.
+ */
+static bool check(
+    std::vector<uint8_t> const &indices,
+    std::vector<uint8_t> const &palette,
+    size_t max_count)
+{
+    constexpr size_t PALETTE_SIZE = 200;
+    std::vector<uint8_t> expected(4 * max_count);
+    std::vector<uint8_t> actual(4 * max_count);
+    for (size_t count = 0; count <= max_count; ++count)
+    {
+        reference_rgba(
+            indices.data(),
+            count,
+            palette.data(),
+            PALETTE_SIZE,
+            expected.data());
+        WAD::palette_to_rgba(
+            indices.data(),
+            count,
+            palette.data(),
+            PALETTE_SIZE,
+            actual.data());
+        if (std::memcmp(expected.data(), actual.data(), 4 * count) != 0)
+        {
+            std::printf("rgba mismatch at %zu pixels\n", count);
+            return false;
+        }
+
+        reference_rgb(
+            indices.data(),
+            count,
+            palette.data(),
+            PALETTE_SIZE,
+            expected.data());
+        WAD::palette_to_rgb(
+            indices.data(),
+            count,
+            palette.data(),
+            PALETTE_SIZE,
+            actual.data());
+        if (std::memcmp(expected.data(), actual.data(), 3 * count) != 0)
+        {
+            std::printf("rgb mismatch at %zu pixels\n", count);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    constexpr size_t MIP_SIZE = 128 * 128;
+    constexpr size_t MAX_CHECKED = 16384;
+    constexpr int RUNS = 200;
+
+    std::minstd_rand rng{1};
+    std::vector<uint8_t> indices(MAX_CHECKED);
+    for (auto &index : indices)
+    {
+        index = static_cast<uint8_t>(rng());
+    }
+    std::vector<uint8_t> palette(3 * 256);
+    for (auto &c : palette)
+    {
+        c = static_cast<uint8_t>(rng());
+    }
+
+    if (!check(indices, palette, MAX_CHECKED))
+    {
+        return 1;
+    }
+    std::printf("output matches the reference loops\n");
+
+    std::vector<uint8_t> out(4 * MIP_SIZE);
+    auto const expand = [&](auto &&func)
+    {
+        return Bench::best_of(
+            RUNS,
+            [&]()
+            {
+                func(
+                    indices.data(),
+                    MIP_SIZE,
+                    palette.data(),
+                    256,
+                    out.data());
+            });
+    };
+    std::printf("128x128 mip, best of %d:\n", RUNS);
+    Bench::report("reference rgba", expand(reference_rgba));
+    Bench::report("palette_to_rgba", expand(WAD::palette_to_rgba));
+    Bench::report("reference rgb", expand(reference_rgb));
+    Bench::report("palette_to_rgb", expand(WAD::palette_to_rgb));
+    return 0;
+}
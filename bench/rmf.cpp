@@ -0,0 +1,417 @@
+/**
+ * rmf.cpp - Time the .rmf loader.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Bench.hpp"
+#include "RMFGen.hpp"
+
+#include <files/rmf/rmf.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using Bench::same_bits;
+
+static bool same_face(RMF::Face const &a, RMF::Face const &b)
+{
+    if (a.vertices.size() != b.vertices.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.vertices.size(); ++i)
+    {
+        if (!same_bits(a.vertices[i], b.vertices[i]))
+        {
+            return false;
+        }
+    }
+    return a.texture_name == b.texture_name
+        && same_bits(a.texture_u, b.texture_u)
+        && same_bits(a.texture_x_shift, b.texture_x_shift)
+        && same_bits(a.texture_v, b.texture_v)
+        && same_bits(a.texture_y_shift, b.texture_y_shift)
+        && same_bits(a.texture_rotation, b.texture_rotation)
+        && same_bits(a.texture_x_scale, b.texture_x_scale)
+        && same_bits(a.texture_y_scale, b.texture_y_scale)
+        && same_bits(a.plane, b.plane);
+}
+
+static bool same_solid(RMF::Solid const &a, RMF::Solid const &b)
+{
+    if (a.visgroup_index != b.visgroup_index || !same_bits(a.color, b.color)
+        || a.faces.size() != b.faces.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.faces.size(); ++i)
+    {
+        if (!same_face(a.faces[i], b.faces[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool same_entity(RMF::Entity const &a, RMF::Entity const &b)
+{
+    if (a.visgroup_index != b.visgroup_index || !same_bits(a.color, b.color)
+        || a.classname != b.classname || a.flags != b.flags
+        || a.kv_pairs != b.kv_pairs || !same_bits(a.position, b.position)
+        || a.brushes.size() != b.brushes.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.brushes.size(); ++i)
+    {
+        if (!same_solid(a.brushes[i], b.brushes[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Find the first difference between two groups.
+ *
+ * @param where Name of the group, used in the description.
+ * @return A description of the difference, or an empty string if the
+ *         groups are the same.
+ */
+static std::string compare(
+    RMF::Group const &a,
+    RMF::Group const &b,
+    std::string const &where)
+{
+    if (a.visgroup_index != b.visgroup_index || !same_bits(a.color, b.color))
+    {
+        return where + ": group fields differ";
+    }
+    if (a.brushes.size() != b.brushes.size()
+        || a.entities.size() != b.entities.size()
+        || a.groups.size() != b.groups.size())
+    {
+        return where + ": object counts differ";
+    }
+    for (size_t i = 0; i < a.brushes.size(); ++i)
+    {
+        if (!same_solid(a.brushes[i], b.brushes[i]))
+        {
+            return where + " brush " + std::to_string(i) + " differs";
+        }
+    }
+    for (size_t i = 0; i < a.entities.size(); ++i)
+    {
+        if (!same_entity(a.entities[i], b.entities[i]))
+        {
+            return where + " entity " + std::to_string(i) + " differs";
+        }
+    }
+    for (size_t i = 0; i < a.groups.size(); ++i)
+    {
+        auto const difference = compare(
+            a.groups[i],
+            b.groups[i],
+            where + " group " + std::to_string(i));
+        if (!difference.empty())
+        {
+            return difference;
+        }
+    }
+    return {};
+}
+
+static bool same_path(RMF::Path const &a, RMF::Path const &b)
+{
+    if (a.name != b.name || a.class_ != b.class_ || a.type != b.type
+        || a.corners.size() != b.corners.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.corners.size(); ++i)
+    {
+        auto const &ca = a.corners[i];
+        auto const &cb = b.corners[i];
+        if (!same_bits(ca.position, cb.position) || ca.index != cb.index
+            || ca.name_override != cb.name_override
+            || ca.kv_pairs != cb.kv_pairs)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Find the first difference between two maps.
+ *
+ * @return A description of the difference, or an empty string if the maps
+ *         are the same.
+ */
+static std::string compare(RMF::RichMap const &a, RMF::RichMap const &b)
+{
+    if (!same_bits(a.version, b.version))
+    {
+        return "versions differ";
+    }
+    if (a.visgroups.size() != b.visgroups.size())
+    {
+        return "visgroup counts differ";
+    }
+    for (size_t i = 0; i < a.visgroups.size(); ++i)
+    {
+        auto const &va = a.visgroups[i];
+        auto const &vb = b.visgroups[i];
+        if (va.name != vb.name || !same_bits(va.color, vb.color)
+            || va.index != vb.index || va.visible != vb.visible)
+        {
+            return "visgroup " + std::to_string(i) + " differs";
+        }
+    }
+    auto const difference = compare(a.objects, b.objects, "world");
+    if (!difference.empty())
+    {
+        return difference;
+    }
+    if (a.worldspawn_name != b.worldspawn_name
+        || a.worldspawn_properties != b.worldspawn_properties)
+    {
+        return "worldspawn differs";
+    }
+    if (a.paths.size() != b.paths.size())
+    {
+        return "path counts differ";
+    }
+    for (size_t i = 0; i < a.paths.size(); ++i)
+    {
+        if (!same_path(a.paths[i], b.paths[i]))
+        {
+            return "path " + std::to_string(i) + " differs";
+        }
+    }
+    if (a.active_camera != b.active_camera
+        || a.cameras.size() != b.cameras.size())
+    {
+        return "cameras differ";
+    }
+    for (size_t i = 0; i < a.cameras.size(); ++i)
+    {
+        if (!same_bits(a.cameras[i], b.cameras[i]))
+        {
+            return "camera " + std::to_string(i) + " differs";
+        }
+    }
+    return {};
+}
+
+/**
+ * Generate a map with every kind of object: 60,000 worldspawn brushes,
+ * 20,000 point entities, 2,000 brush entities, 100 chains of groups nested
+ * 10 deep, plus visgroups, paths and cameras.
+ */
+static RMF::RichMap generate()
+{
+    auto map = Bench::make_rich_map();
+
+    for (int i = 0; i < 8; ++i)
+    {
+        map.visgroups.push_back(
+            {"visgroup" + std::to_string(i),
+             {uint8_t(i * 30), 128, 255},
+             i + 1,
+             i % 2 == 0});
+    }
+
+    auto &world = map.objects;
+    for (int i = 0; i < 60'000; ++i)
+    {
+        world.brushes.push_back(Bench::make_cube(
+            (i % 250) * 64.0f,
+            (i / 250) * 64.0f,
+            0.0f,
+            32.0f,
+            i % 3 == 0 ? "GENERIC015V" : "+0~FIFTS_LGHT01"));
+        world.brushes.back().visgroup_index = i % 9;
+    }
+    for (int i = 0; i < 20'000; ++i)
+    {
+        world.entities.push_back(Bench::make_point_entity(i));
+    }
+    for (int i = 0; i < 2'000; ++i)
+    {
+        auto entity = Bench::make_point_entity(i);
+        entity.classname = "func_wall";
+        entity.position = {0.0f, 0.0f, 0.0f};
+        entity.brushes.push_back(
+            Bench::make_cube(i * 64.0f, 0.0f, 128.0f, 16.0f, "CRATE01"));
+        entity.brushes.push_back(
+            Bench::make_cube(i * 64.0f, 0.0f, 160.0f, 16.0f, "CRATE02"));
+        world.entities.push_back(std::move(entity));
+    }
+    for (int chain = 0; chain < 100; ++chain)
+    {
+        auto *group = &world;
+        for (int depth = 0; depth < 10; ++depth)
+        {
+            group->groups.emplace_back();
+            group = &group->groups.back();
+            group->visgroup_index = depth % 9;
+            group->color = {uint8_t(chain), uint8_t(depth), 0};
+            for (int i = 0; i < 4; ++i)
+            {
+                group->brushes.push_back(Bench::make_cube(
+                    chain * 64.0f,
+                    depth * 64.0f,
+                    i * 64.0f - 512.0f,
+                    48.0f,
+                    "BRICK"));
+            }
+            group->entities.push_back(
+                Bench::make_point_entity(chain * 10 + depth));
+        }
+    }
+
+    for (int i = 0; i < 10; ++i)
+    {
+        RMF::Path path{};
+        path.name = "path" + std::to_string(i);
+        path.class_ = "path_corner";
+        path.type = i % 3;
+        for (int c = 0; c < 8; ++c)
+        {
+            path.corners.push_back(
+                {{c * 32.0f, i * 32.0f, 0.0f},
+                 c,
+                 "",
+                 {{"speed", std::to_string(c * 10)}}});
+        }
+        map.paths.push_back(std::move(path));
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        map.cameras.push_back(
+            {{i * 100.0f, 0.0f, 64.0f},
+             {0.0f, i * 100.0f, 0.0f}});
+    }
+    map.active_camera = 1;
+    return map;
+}
+
+/**
+ * Time loading, saving and parsing one file.
+ *
+ * @param expected What the file should load as, or null if unknown. The
+ *                 loaded map is always checked against a save/parse round
+ *                 trip of itself.
+ * @return Whether the file loaded and all checks passed.
+ */
+static bool run(std::string const &path, RMF::RichMap const *expected)
+{
+    constexpr int RUNS = 3;
+
+    std::printf("%s, best of %d:\n", path.c_str(), RUNS);
+    RMF::RichMap loaded{};
+    try
+    {
+        Bench::report(
+            "load",
+            Bench::best_of(RUNS, [&]() { loaded = RMF::load(path); }));
+    }
+    catch (RMF::LoadError const &e)
+    {
+        std::printf("  failed to load: %s\n", e.what());
+        return false;
+    }
+
+    bool ok = true;
+    if (expected)
+    {
+        auto const difference = compare(*expected, loaded);
+        if (!difference.empty())
+        {
+            std::printf("  load differs: %s\n", difference.c_str());
+            ok = false;
+        }
+    }
+
+    std::string saved{};
+    Bench::report(
+        "save",
+        Bench::best_of(
+            RUNS,
+            [&]()
+            {
+                std::ostringstream out{};
+                RMF::save(out, loaded);
+                saved = out.str();
+            }));
+
+    RMF::RichMap parsed{};
+    Bench::report(
+        "parse",
+        Bench::best_of(RUNS, [&]() { parsed = RMF::parse(saved); }));
+    auto const difference = compare(loaded, parsed);
+    if (!difference.empty())
+    {
+        std::printf("  round trip differs: %s\n", difference.c_str());
+        ok = false;
+    }
+    return ok;
+}
+
+/**
+ * Usage: bench-rmf [FILE...]
+ *
+ * Times RMF::load(), RMF::save() and RMF::parse() on each file, and checks
+ * that a save/parse round trip gives back the same map. With no files, a
+ * large map is generated and saved to a temporary file first, and the
+ * loaded map is also checked against the generated one. Exits with 1 if
+ * any check fails or a file fails to load.
+ */
+int main(int argc, char *argv[])
+{
+    bool ok = true;
+    if (argc < 2)
+    {
+        auto const map = generate();
+        auto const path = std::filesystem::temp_directory_path()
+                        / "sickle-bench.rmf";
+        {
+            std::ofstream file{path, std::ios::out | std::ios::binary};
+            RMF::save(file, map);
+            if (!file)
+            {
+                std::fprintf(stderr, "failed to write %s\n", path.c_str());
+                return 2;
+            }
+        }
+        ok = run(path.string(), &map);
+        std::filesystem::remove(path);
+    }
+    for (int i = 1; i < argc; ++i)
+    {
+        ok = run(argv[i], nullptr) && ok;
+    }
+    std::printf(ok ? "all checks passed\n" : "checks failed\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+/**
+ * rmf_groups.cpp - Time importing deeply nested .rmf groups.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Bench.hpp"
+#include "RMFGen.hpp"
+
+#include <editor/core/gamedefinition/GameDefinition.hpp>
+#include <editor/world/World.hpp>
+#include <files/fgd/fgd.hpp>
+#include <files/rmf/rmf.hpp>
+
+#include <glibmm.h>
+
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <stack>
+#include <utility>
+#include <vector>
+
+using namespace Sickle::Editor;
+
+static constexpr int CHAINS = 100;
+static constexpr int DEPTH = 50;
+static constexpr int BRUSHES_PER_GROUP = 4;
+static constexpr size_t GROUPS = CHAINS * DEPTH;
+static constexpr size_t BRUSHES = GROUPS * BRUSHES_PER_GROUP;
+
+/** Objects found by a traversal. */
+struct Counts
+{
+    size_t groups{0};
+    size_t brushes{0};
+};
+
+/** Generate CHAINS chains of groups, each nested DEPTH deep. */
+static RMF::RichMap generate()
+{
+    auto map = Bench::make_rich_map();
+    for (int chain = 0; chain < CHAINS; ++chain)
+    {
+        auto *group = &map.objects;
+        for (int depth = 0; depth < DEPTH; ++depth)
+        {
+            group->groups.emplace_back();
+            group = &group->groups.back();
+            group->visgroup_index = 0;
+            group->color = {uint8_t(chain), uint8_t(depth), 0};
+            for (int i = 0; i < BRUSHES_PER_GROUP; ++i)
+            {
+                group->brushes.push_back(Bench::make_cube(
+                    chain * 64.0f,
+                    depth * 64.0f,
+                    i * 64.0f,
+                    32.0f,
+                    "BRICK"));
+            }
+        }
+    }
+    return map;
+}
+
+/**
+ * Walk the groups the way World::create() used to, with a stack of
+ * RMF::Group values. Every push copies the group's whole subtree.
+ */
+static Counts walk_copying(RMF::RichMap const &map)
+{
+    Counts counts{};
+    std::stack<RMF::Group> stack{};
+    stack.push(map.objects);
+    while (!stack.empty())
+    {
+        auto const group = stack.top();
+        stack.pop();
+        counts.brushes += group.brushes.size();
+        for (auto const &child : group.groups)
+        {
+            ++counts.groups;
+            stack.push(child);
+        }
+    }
+    return counts;
+}
+
+/** Walk the groups with a stack of pointers, as World::create() does. */
+static Counts walk_pointers(RMF::RichMap const &map)
+{
+    Counts counts{};
+    std::vector<RMF::Group const *> stack{&map.objects};
+    while (!stack.empty())
+    {
+        auto const group = stack.back();
+        stack.pop_back();
+        counts.brushes += group->brushes.size();
+        for (auto const &child : group->groups)
+        {
+            ++counts.groups;
+            stack.push_back(&child);
+        }
+    }
+    return counts;
+}
+
+/**
+ * Check that a world holds CHAINS chains of groups, each DEPTH deep, with
+ * BRUSHES_PER_GROUP brushes in every group, all of them in worldspawn.
+ *
+ * @return Whether the world has the expected structure.
+ */
+static bool check_world(WorldRef const &world)
+{
+    if (world->worldspawn()->brushes().size() != BRUSHES
+        || world->groups().size() != CHAINS)
+    {
+        return false;
+    }
+    for (auto const &top : world->groups())
+    {
+        auto group = top;
+        for (int depth = 0; depth < DEPTH; ++depth)
+        {
+            if (group->brushes().size() != BRUSHES_PER_GROUP
+                || !group->entities().empty())
+            {
+                return false;
+            }
+            auto const &children = group->groups();
+            if (depth + 1 == DEPTH)
+            {
+                if (!children.empty())
+                {
+                    return false;
+                }
+                break;
+            }
+            if (children.size() != 1)
+            {
+                return false;
+            }
+            group = children.front();
+        }
+    }
+    return true;
+}
+
+/**
+ * Usage: bench-rmf-groups
+ *
+ * Generates CHAINS chains of groups nested DEPTH deep, then times walking
+ * them with a copying stack and a pointer stack, and times
+ * World::create(). Exits with 1 if any of them finds the wrong structure.
+ */
+int main()
+{
+    constexpr int RUNS = 3;
+
+    Glib::init();
+    // Only worldspawn is needed. Without it, every world complains that the
+    // class is missing.
+    std::vector<std::shared_ptr<FGD::Attribute>> const no_attributes{};
+    std::vector<std::shared_ptr<FGD::Property>> const no_properties{};
+    GameDefinition::instance().add_game(FGD::GameDef{
+        {std::make_shared<FGD::SolidClass>(
+            no_attributes,
+            "worldspawn",
+            std::nullopt,
+            no_properties)}
+    });
+
+    auto const map = generate();
+    std::printf(
+        "%zu groups in %d chains nested %d deep, %zu brushes, best of %d:\n",
+        GROUPS,
+        CHAINS,
+        DEPTH,
+        BRUSHES,
+        RUNS);
+
+    bool ok = true;
+    std::pair<char const *, Counts (*)(RMF::RichMap const &)> const walks[] = {
+        {"copying stack", walk_copying },
+        {"pointer stack", walk_pointers},
+    };
+    for (auto const &[name, walk_func] : walks)
+    {
+        // Structured bindings can't be captured in C++17.
+        auto const walk = walk_func;
+        Counts counts{};
+        Bench::report(
+            name,
+            Bench::best_of(RUNS, [&]() { counts = walk(map); }));
+        if (counts.groups != GROUPS || counts.brushes != BRUSHES)
+        {
+            std::printf(
+                "  %s found %zu groups and %zu brushes\n",
+                name,
+                counts.groups,
+                counts.brushes);
+            ok = false;
+        }
+    }
+
+    // Worlds are kept until the end, so destroying one isn't timed.
+    std::vector<WorldRef> worlds{};
+    Bench::report(
+        "World::create",
+        Bench::best_of(
+            RUNS,
+            [&]() { worlds.push_back(World::create(map)); }));
+    if (!check_world(worlds.back()))
+    {
+        std::printf("  World::create built the wrong groups\n");
+        ok = false;
+    }
+
+    std::printf(ok ? "all checks passed\n" : "checks failed\n");
+    return ok ? 0 : 1;
+}
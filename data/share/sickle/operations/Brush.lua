@@ -63,4 +63,37 @@ add_operation(
             {b.x, b.y, a.z},
             {b.x, b.y, b.z}
         )
-    end)
\ No newline at end of file
+    end)
+
+add_operation(
+    "Brush", "Split", "brush", {"vec3", "vec3"},
+    function(editor, brushes, point, normal)
+        editor:clip_brushes(brushes, point, normal, "both")
+    end,
+    {geo.vec3.new(), geo.vec3.new(0, 0, 1)})
+
+add_operation(
+    "Brush", "Clip", "brush", {"vec3", "vec3"},
+    function(editor, brushes, point, normal)
+        editor:clip_brushes(brushes, point, normal, "below")
+    end,
+    {geo.vec3.new(), geo.vec3.new(0, 0, 1)})
+
+add_operation(
+    "Brush", "Carve", "brush", {},
+    function(editor, brushes)
+        editor:carve(brushes)
+    end)
+
+add_operation(
+    "Brush", "Hollow", "brush", {"f"},
+    function(editor, brushes, thickness)
+        editor:hollow_brushes(brushes, thickness)
+    end,
+    {16})
+
+add_operation(
+    "Brush", "Merge", "brush", {},
+    function(editor, brushes)
+        editor:merge_brushes(brushes)
+    end)
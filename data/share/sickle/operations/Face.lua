@@ -4,4 +4,22 @@ add_operation(
         for _,f in ipairs(faces) do
             f:set_texture(texture_id)
         end
-    end)
\ No newline at end of file
+    end)
+
+add_operation(
+    "Face", "SelectByTexture", "face", {"texture"},
+    function(editor, _, texture_id)
+        local selection = editor:get_selection()
+        selection:clear()
+        for _,f in ipairs(editor:get_faces_with_texture(texture_id)) do
+            selection:add(f)
+        end
+    end)
+
+add_operation(
+    "Face", "ReplaceTexture", "face", {"texture", "texture"},
+    function(editor, _, find_id, replace_id)
+        for _,f in ipairs(editor:get_faces_with_texture(find_id)) do
+            f:set_texture(replace_id)
+        end
+    end)
@@ -0,0 +1,377 @@
+/**
+ * classify.cpp - Batch point/plane classification.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "convexhull.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SE_CONVEXHULL_X86 1
+#include <immintrin.h>
+#else
+#define SE_CONVEXHULL_X86 0
+#endif
+
+/* ===[ Kernels ]=== */
+/**
+ * Every batch boils down to evaluating `x[i]*p + y[i]*q + z[i]*r + w` for
+ * each i, where W is either per-element or constant. For points against a
+ * plane, XYZ are the points and PQR are the plane's normal. For planes
+ * against a point, XYZ are the plane normals and PQR are the point.
+ */
+struct Batch
+{
+    float const *x, *y, *z;
+    /// Per-element constant term, or nullptr to use W_CONST instead.
+    float const *w;
+    float w_const;
+    float p, q, r;
+    size_t count;
+};
+
+using Kernel = void (*)(Batch const &, Classification *);
+/// Returns the index of the first element above, or the batch's count.
+using FirstAboveKernel = size_t (*)(Batch const &);
+
+static Classification classify_distance(float d)
+{
+    if (d > HalfPlane::EPSILON)
+    {
+        return ABOVE;
+    }
+    else if (d < -HalfPlane::EPSILON)
+    {
+        return BELOW;
+    }
+    else
+    {
+        return ON;
+    }
+}
+
+static void classify_scalar(Batch const &b, Classification *out)
+{
+    for (size_t i = 0; i < b.count; ++i)
+    {
+        auto const w = b.w ? b.w[i] : b.w_const;
+        out[i] = classify_distance(
+            b.x[i] * b.p + b.y[i] * b.q + b.z[i] * b.r + w);
+    }
+}
+
+static size_t first_above_scalar(Batch const &b)
+{
+    for (size_t i = 0; i < b.count; ++i)
+    {
+        auto const w = b.w ? b.w[i] : b.w_const;
+        if (b.x[i] * b.p + b.y[i] * b.q + b.z[i] * b.r + w > HalfPlane::EPSILON)
+        {
+            return i;
+        }
+    }
+    return b.count;
+}
+
+#if SE_CONVEXHULL_X86
+/** Expand above/below lane masks into Classifications. */
+static void write_masks(int above, int below, size_t lanes, Classification *out)
+{
+    for (size_t k = 0; k < lanes; ++k)
+    {
+        if (above & (1 << k))
+        {
+            out[k] = ABOVE;
+        }
+        else if (below & (1 << k))
+        {
+            out[k] = BELOW;
+        }
+        else
+        {
+            out[k] = ON;
+        }
+    }
+}
+
+__attribute__((target("sse2"))) static void classify_sse(
+    Batch const &b,
+    Classification *out)
+{
+    auto const p = _mm_set1_ps(b.p);
+    auto const q = _mm_set1_ps(b.q);
+    auto const r = _mm_set1_ps(b.r);
+    auto const w_const = _mm_set1_ps(b.w_const);
+    auto const eps = _mm_set1_ps(HalfPlane::EPSILON);
+    auto const neg_eps = _mm_set1_ps(-HalfPlane::EPSILON);
+
+    size_t i = 0;
+    for (; i + 4 <= b.count; i += 4)
+    {
+        auto const w = b.w ? _mm_loadu_ps(b.w + i) : w_const;
+        auto d = _mm_mul_ps(_mm_loadu_ps(b.x + i), p);
+        d = _mm_add_ps(d, _mm_mul_ps(_mm_loadu_ps(b.y + i), q));
+        d = _mm_add_ps(d, _mm_mul_ps(_mm_loadu_ps(b.z + i), r));
+        d = _mm_add_ps(d, w);
+        write_masks(
+            _mm_movemask_ps(_mm_cmpgt_ps(d, eps)),
+            _mm_movemask_ps(_mm_cmplt_ps(d, neg_eps)),
+            4,
+            out + i);
+    }
+
+    auto tail = b;
+    tail.x += i;
+    tail.y += i;
+    tail.z += i;
+    tail.w = b.w ? b.w + i : nullptr;
+    tail.count -= i;
+    classify_scalar(tail, out + i);
+}
+
+__attribute__((target("sse2"))) static size_t first_above_sse(Batch const &b)
+{
+    auto const p = _mm_set1_ps(b.p);
+    auto const q = _mm_set1_ps(b.q);
+    auto const r = _mm_set1_ps(b.r);
+    auto const w_const = _mm_set1_ps(b.w_const);
+    auto const eps = _mm_set1_ps(HalfPlane::EPSILON);
+
+    size_t i = 0;
+    for (; i + 4 <= b.count; i += 4)
+    {
+        auto const w = b.w ? _mm_loadu_ps(b.w + i) : w_const;
+        auto d = _mm_mul_ps(_mm_loadu_ps(b.x + i), p);
+        d = _mm_add_ps(d, _mm_mul_ps(_mm_loadu_ps(b.y + i), q));
+        d = _mm_add_ps(d, _mm_mul_ps(_mm_loadu_ps(b.z + i), r));
+        d = _mm_add_ps(d, w);
+        if (auto const above = _mm_movemask_ps(_mm_cmpgt_ps(d, eps)))
+        {
+            return i + __builtin_ctz(above);
+        }
+    }
+
+    auto tail = b;
+    tail.x += i;
+    tail.y += i;
+    tail.z += i;
+    tail.w = b.w ? b.w + i : nullptr;
+    tail.count -= i;
+    return i + first_above_scalar(tail);
+}
+
+__attribute__((target("avx2"))) static void classify_avx2(
+    Batch const &b,
+    Classification *out)
+{
+    auto const p = _mm256_set1_ps(b.p);
+    auto const q = _mm256_set1_ps(b.q);
+    auto const r = _mm256_set1_ps(b.r);
+    auto const w_const = _mm256_set1_ps(b.w_const);
+    auto const eps = _mm256_set1_ps(HalfPlane::EPSILON);
+    auto const neg_eps = _mm256_set1_ps(-HalfPlane::EPSILON);
+
+    size_t i = 0;
+    for (; i + 8 <= b.count; i += 8)
+    {
+        // Multiply and add separately rather than using FMA, so results
+        // match the scalar path bit for bit.
+        auto const w = b.w ? _mm256_loadu_ps(b.w + i) : w_const;
+        auto d = _mm256_mul_ps(_mm256_loadu_ps(b.x + i), p);
+        d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_loadu_ps(b.y + i), q));
+        d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_loadu_ps(b.z + i), r));
+        d = _mm256_add_ps(d, w);
+        write_masks(
+            _mm256_movemask_ps(_mm256_cmp_ps(d, eps, _CMP_GT_OQ)),
+            _mm256_movemask_ps(_mm256_cmp_ps(d, neg_eps, _CMP_LT_OQ)),
+            8,
+            out + i);
+    }
+
+    auto tail = b;
+    tail.x += i;
+    tail.y += i;
+    tail.z += i;
+    tail.w = b.w ? b.w + i : nullptr;
+    tail.count -= i;
+    classify_sse(tail, out + i);
+}
+#endif // SE_CONVEXHULL_X86
+
+/** Kernels for the widest instruction set the CPU supports. */
+struct Kernels
+{
+    Kernel classify;
+    FirstAboveKernel first_above;
+};
+
+/** Pick the widest kernels the CPU supports. Only checked once. */
+static Kernels const &get_kernels()
+{
+    static Kernels const kernels = []() -> Kernels
+    {
+#if SE_CONVEXHULL_X86
+        __builtin_cpu_init();
+        // first_above() usually exits within the first few planes, and a
+        // brush rarely has more than a few dozen, so 8 lanes mostly means
+        // wasted work there. It sticks with 4.
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return {classify_avx2, first_above_sse};
+        }
+        if (__builtin_cpu_supports("sse2"))
+        {
+            return {classify_sse, first_above_sse};
+        }
+#endif
+        return {classify_scalar, first_above_scalar};
+    }();
+    return kernels;
+}
+
+/* ===[ PointBlock ]=== */
+PointBlock::PointBlock(std::vector<glm::vec3> const &points)
+{
+    reserve(points.size());
+    for (auto const &point : points)
+    {
+        push_back(point);
+    }
+}
+
+void PointBlock::push_back(glm::vec3 const &point)
+{
+    x.push_back(point.x);
+    y.push_back(point.y);
+    z.push_back(point.z);
+}
+
+void PointBlock::reserve(size_t count)
+{
+    x.reserve(count);
+    y.reserve(count);
+    z.reserve(count);
+}
+
+void PointBlock::clear()
+{
+    x.clear();
+    y.clear();
+    z.clear();
+}
+
+size_t PointBlock::size() const
+{
+    return x.size();
+}
+
+glm::vec3 PointBlock::at(size_t i) const
+{
+    return {x.at(i), y.at(i), z.at(i)};
+}
+
+/* ===[ PlaneBlock ]=== */
+PlaneBlock::PlaneBlock(std::vector<HalfPlane> const &planes)
+{
+    reserve(planes.size());
+    for (auto const &plane : planes)
+    {
+        push_back(plane);
+    }
+}
+
+void PlaneBlock::push_back(HalfPlane const &plane)
+{
+    a.push_back(plane.a);
+    b.push_back(plane.b);
+    c.push_back(plane.c);
+    d.push_back(plane.d);
+}
+
+void PlaneBlock::reserve(size_t count)
+{
+    a.reserve(count);
+    b.reserve(count);
+    c.reserve(count);
+    d.reserve(count);
+}
+
+void PlaneBlock::clear()
+{
+    a.clear();
+    b.clear();
+    c.clear();
+    d.clear();
+}
+
+size_t PlaneBlock::size() const
+{
+    return a.size();
+}
+
+HalfPlane PlaneBlock::at(size_t i) const
+{
+    return {a.at(i), b.at(i), c.at(i), d.at(i)};
+}
+
+/* ===[ Batch Classification ]=== */
+static Batch make_batch(HalfPlane const &plane, PointBlock const &points)
+{
+    return Batch{
+        points.x.data(),
+        points.y.data(),
+        points.z.data(),
+        nullptr,
+        plane.d,
+        plane.a,
+        plane.b,
+        plane.c,
+        points.size()};
+}
+
+static Batch make_batch(PlaneBlock const &planes, glm::vec3 const &point)
+{
+    return Batch{
+        planes.a.data(),
+        planes.b.data(),
+        planes.c.data(),
+        planes.d.data(),
+        0.0f,
+        point.x,
+        point.y,
+        point.z,
+        planes.size()};
+}
+
+void classify(
+    HalfPlane const &plane,
+    PointBlock const &points,
+    Classification *out)
+{
+    get_kernels().classify(make_batch(plane, points), out);
+}
+
+void classify(
+    PlaneBlock const &planes,
+    glm::vec3 const &point,
+    Classification *out)
+{
+    get_kernels().classify(make_batch(planes, point), out);
+}
+
+size_t first_above(PlaneBlock const &planes, glm::vec3 const &point)
+{
+    return get_kernels().first_above(make_batch(planes, point));
+}
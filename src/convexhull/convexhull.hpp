@@ -19,23 +19,12 @@
 #ifndef SE_CONVEXHULL_HPP
 #define SE_CONVEXHULL_HPP
 
+#include "weldset.hpp"
+
 #include <glm/glm.hpp>
 
-#include <unordered_set>
 #include <vector>
 
-// FIXME: TEMP
-/** std::hash template so glm::vec3 can be used in std::unordered_set. */
-template<>
-struct std::hash<glm::vec3>
-{
-    std::size_t operator()(glm::vec3 const &vec) const noexcept
-    {
-        std::hash<float> const hashf{};
-        return hashf(vec.x) ^ hashf(vec.y) ^ hashf(vec.z);
-    }
-};
-
 enum Classification
 {
     ON,
@@ -74,25 +63,132 @@ public:
 };
 
 template<>
-struct std::hash<HalfPlane>
+struct WeldTraits<glm::vec3>
+{
+    static constexpr size_t N = 3;
+    static constexpr float EPSILON = HalfPlane::EPSILON;
+
+    static std::array<float, N> components(glm::vec3 const &v)
+    {
+        return {v.x, v.y, v.z};
+    }
+};
+
+template<>
+struct WeldTraits<HalfPlane>
 {
-    std::size_t operator()(HalfPlane const &hp) const noexcept
+    static constexpr size_t N = 4;
+    static constexpr float EPSILON = HalfPlane::EPSILON;
+
+    static std::array<float, N> components(HalfPlane const &hp)
     {
-        static constexpr float EPSILON_INV = 1.0f / HalfPlane::EPSILON;
-        std::hash<float> const hashf{};
-        return (
-            hashf(roundf(hp.a * EPSILON_INV) * HalfPlane::EPSILON)
-            ^ hashf(roundf(hp.b * EPSILON_INV) * HalfPlane::EPSILON)
-            ^ hashf(roundf(hp.c * EPSILON_INV) * HalfPlane::EPSILON)
-            ^ hashf(roundf(hp.d * EPSILON_INV) * HalfPlane::EPSILON));
+        return {hp.a, hp.b, hp.c, hp.d};
     }
 };
 
+/** Set of points, where points within HalfPlane::EPSILON are merged. */
+using VertexSet = WeldSet<glm::vec3>;
+
+/** Set of half-planes, where half-planes that compare equal are merged. */
+using PlaneSet = WeldSet<HalfPlane>;
+
+/** Structure-of-arrays block of points, for batch classification. */
+struct PointBlock
+{
+    std::vector<float> x{}, y{}, z{};
+
+    PointBlock() = default;
+    explicit PointBlock(std::vector<glm::vec3> const &points);
+
+    void push_back(glm::vec3 const &point);
+    void reserve(size_t count);
+    void clear();
+    size_t size() const;
+    glm::vec3 at(size_t i) const;
+};
+
+/** Structure-of-arrays block of half-planes, for batch classification. */
+struct PlaneBlock
+{
+    std::vector<float> a{}, b{}, c{}, d{};
+
+    PlaneBlock() = default;
+    explicit PlaneBlock(std::vector<HalfPlane> const &planes);
+
+    void push_back(HalfPlane const &plane);
+    void reserve(size_t count);
+    void clear();
+    size_t size() const;
+    HalfPlane at(size_t i) const;
+};
+
+/**
+ * Classify every point in POINTS against PLANE, as HalfPlane::classify would.
+ * Uses SIMD instructions when the CPU supports them.
+ *
+ * @param out Receives one Classification per point. Must have room for
+ *            `points.size()` entries.
+ */
+void classify(
+    HalfPlane const &plane,
+    PointBlock const &points,
+    Classification *out);
+
+/**
+ * Classify POINT against every plane in PLANES, as HalfPlane::classify would.
+ * Uses SIMD instructions when the CPU supports them.
+ *
+ * @param out Receives one Classification per plane. Must have room for
+ *            `planes.size()` entries.
+ */
+void classify(
+    PlaneBlock const &planes,
+    glm::vec3 const &point,
+    Classification *out);
+
+/**
+ * Find the first plane in PLANES which POINT lies above.
+ *
+ * @return Index of the plane, or `planes.size()` if POINT is on or below all
+ *         of them.
+ */
+size_t first_above(PlaneBlock const &planes, glm::vec3 const &point);
+
+/**
+ * Convex polygon lying on a plane. Points are ordered counterclockwise when
+ * viewed from above the plane. Points are stored in double precision, since
+ * the polygon starts out very large and is clipped down repeatedly.
+ */
+class Winding
+{
+public:
+    /** Half the side length of the initial winding. */
+    static constexpr double BASE_SIZE = 1048576.0;
+
+    /** Create a square winding covering (practically) all of PLANE. */
+    explicit Winding(HalfPlane const &plane);
+
+    /** Cut away the part of the winding which lies above PLANE. */
+    void clip(HalfPlane const &plane);
+
+    /** Check if the winding has been clipped away entirely. */
+    bool empty() const;
+
+    /** Get the winding's points. */
+    std::vector<glm::vec3> points() const;
+
+private:
+    std::vector<glm::dvec3> _points{};
+
+    void _remove_degenerate_points();
+};
+
 /**
  * Vertex enumeration. Given a list of half-planes comprising a convex
- * polyhedron, return the vertices of said polyhedron.
+ * polyhedron, return the vertices of said polyhedron. Vertices shared by
+ * more than three half-planes are only returned once.
  */
-std::unordered_set<glm::vec3> vertex_enumeration(
+std::vector<glm::vec3> vertex_enumeration(
     std::vector<HalfPlane> const &facets);
 
 /**
@@ -102,4 +198,14 @@ std::unordered_set<glm::vec3> vertex_enumeration(
 std::pair<std::vector<HalfPlane>, std::vector<glm::vec3>> facet_enumeration(
     std::vector<glm::vec3> const &vertices);
 
+/**
+ * Face enumeration. Given a list of half-planes comprising a convex
+ * polyhedron, return the polygon each half-plane contributes to said
+ * polyhedron, in the same order as the half-planes. Polygons are ordered
+ * counterclockwise when viewed from outside the polyhedron. A half-plane which
+ * does not touch the polyhedron gets an empty polygon.
+ */
+std::vector<std::vector<glm::vec3>> face_enumeration(
+    std::vector<HalfPlane> const &facets);
+
 #endif
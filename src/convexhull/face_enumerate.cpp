@@ -0,0 +1,191 @@
+/**
+ * face_enumerate.cpp - Face enumeration algorithm.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "convexhull.hpp"
+
+#include <algorithm>
+#include <array>
+
+/** Signed distance from P to PLANE, calculated in double precision. */
+static double distance_to(HalfPlane const &plane, glm::dvec3 const &p)
+{
+    return plane.a * p.x + plane.b * p.y + plane.c * p.z + plane.d;
+}
+
+Winding::Winding(HalfPlane const &plane)
+{
+    glm::dvec3 const normal{plane.normal()};
+
+    // Pick the world axis least aligned with the normal to build the basis.
+    auto const n = glm::abs(normal);
+    glm::dvec3 up{0.0, 0.0, 1.0};
+    if (n.z >= n.x && n.z >= n.y)
+    {
+        up = glm::dvec3{1.0, 0.0, 0.0};
+    }
+
+    // RIGHT x UP == NORMAL, so walking the corners below in order is
+    // counterclockwise when viewed from above the plane.
+    up = glm::normalize(up - normal * glm::dot(up, normal));
+    auto const right = glm::cross(up, normal);
+
+    auto const origin = normal * -static_cast<double>(plane.d);
+    auto const r = right * BASE_SIZE;
+    auto const u = up * BASE_SIZE;
+
+    _points = {origin + r - u, origin + r + u, origin - r + u, origin - r - u};
+}
+
+void Winding::clip(HalfPlane const &plane)
+{
+    if (empty())
+    {
+        return;
+    }
+
+    std::vector<double> distances{};
+    std::vector<Classification> sides{};
+    distances.reserve(_points.size() + 1);
+    sides.reserve(_points.size() + 1);
+
+    size_t above = 0, below = 0;
+    for (auto const &point : _points)
+    {
+        auto const d = distance_to(plane, point);
+        distances.push_back(d);
+        if (d > HalfPlane::EPSILON)
+        {
+            sides.push_back(ABOVE);
+            above++;
+        }
+        else if (d < -HalfPlane::EPSILON)
+        {
+            sides.push_back(BELOW);
+            below++;
+        }
+        else
+        {
+            sides.push_back(ON);
+        }
+    }
+
+    // Nothing to clip away.
+    if (above == 0)
+    {
+        return;
+    }
+    // Everything is clipped away.
+    if (below == 0)
+    {
+        _points.clear();
+        return;
+    }
+
+    distances.push_back(distances.front());
+    sides.push_back(sides.front());
+
+    std::vector<glm::dvec3> clipped{};
+    clipped.reserve(_points.size() + 1);
+    for (size_t i = 0; i < _points.size(); ++i)
+    {
+        auto const &p1 = _points[i];
+        if (sides[i] == ON)
+        {
+            clipped.push_back(p1);
+            continue;
+        }
+        if (sides[i] == BELOW)
+        {
+            clipped.push_back(p1);
+        }
+
+        // Only split edges which cross from one side to the other.
+        if (sides[i + 1] == ON || sides[i + 1] == sides[i])
+        {
+            continue;
+        }
+
+        auto const &p2 = _points[(i + 1) % _points.size()];
+        auto const t = distances[i] / (distances[i] - distances[i + 1]);
+        clipped.push_back(p1 + (p2 - p1) * t);
+    }
+    _points = clipped;
+    _remove_degenerate_points();
+}
+
+bool Winding::empty() const
+{
+    return _points.size() < 3;
+}
+
+std::vector<glm::vec3> Winding::points() const
+{
+    std::vector<glm::vec3> out{};
+    out.reserve(_points.size());
+    for (auto const &point : _points)
+    {
+        out.emplace_back(point);
+    }
+    return out;
+}
+
+void Winding::_remove_degenerate_points()
+{
+    // Drop points which are too close to their predecessor to be considered
+    // distinct.
+    std::vector<glm::dvec3> unique{};
+    unique.reserve(_points.size());
+    for (auto const &point : _points)
+    {
+        if (unique.empty()
+            || glm::length(point - unique.back()) > HalfPlane::EPSILON)
+        {
+            unique.push_back(point);
+        }
+    }
+    while (unique.size() > 1
+           && glm::length(unique.front() - unique.back()) <= HalfPlane::EPSILON)
+    {
+        unique.pop_back();
+    }
+    _points = unique;
+}
+
+std::vector<std::vector<glm::vec3>> face_enumeration(
+    std::vector<HalfPlane> const &facets)
+{
+    // Each facet's polygon starts out as a huge quad lying on the facet, which
+    // is then cut down to size by every other facet. Since the clipping
+    // preserves winding order, no sorting is needed afterwards.
+    std::vector<std::vector<glm::vec3>> faces{};
+    faces.reserve(facets.size());
+    for (size_t i = 0; i < facets.size(); ++i)
+    {
+        Winding winding{facets[i]};
+        for (size_t j = 0; j < facets.size() && !winding.empty(); ++j)
+        {
+            if (j != i)
+            {
+                winding.clip(facets[j]);
+            }
+        }
+        faces.push_back(winding.empty() ? std::vector<glm::vec3>{}
+                                        : winding.points());
+    }
+    return faces;
+}
@@ -1,6 +1,6 @@
 /**
  * facet_enumerate.cpp - Facet enumeration algorithm.
- * Copyright (C) 2023 Trevor Last
+ * Copyright (C) 2023-2024 Trevor Last
  *
  *  This program is free software: you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -23,245 +23,213 @@
 
 #include <algorithm>
 #include <array>
-#include <map>
-#include <memory>
-#include <optional>
+#include <cassert>
 #include <stdexcept>
-#include <unordered_map>
 
 /* ===[ Facet Enumeration Utils ]=== */
-enum class EdgeCompare
+/**
+ * Convex hull stored as a half-edge mesh. Vertices are indices into the point
+ * list the hull is built from. Facets are triangles, with their points ordered
+ * clockwise when viewed from outside the hull (matching HalfPlane's
+ * constructor).
+ *
+ * Facets and half-edges are never erased, only marked as dead, so indices
+ * stay valid for the lifetime of the hull.
+ */
+class ConvexHull
 {
-    EQUAL,
-    NOTEQUAL,
-    OPPOSITE,
-};
+public:
+    static constexpr size_t NONE = static_cast<size_t>(-1);
 
-struct Edge
-{
-    glm::vec3 first, second;
+    struct HalfEdge
+    {
+        /// Vertex the edge starts at.
+        size_t tail;
+        /// Opposite half-edge, belonging to the neighboring facet.
+        size_t twin;
+        /// Next half-edge around the facet.
+        size_t next;
+        /// Facet the edge belongs to.
+        size_t facet;
+    };
 
-    Edge(glm::vec3 const &first, glm::vec3 const &second)
-    : first{first}
-    , second{second}
+    struct Facet
+    {
+        HalfPlane plane;
+        /// First of the facet's three half-edges.
+        size_t edge;
+        /// Points above this facet which have not been added to the hull yet.
+        std::vector<size_t> conflicts{};
+        bool alive{true};
+        /// Used while searching for the horizon.
+        bool visible{false};
+    };
+
+    std::vector<glm::vec3> const &points;
+    std::vector<Facet> facets{};
+    std::vector<HalfEdge> edges{};
+
+    explicit ConvexHull(std::vector<glm::vec3> const &points)
+    : points{points}
     {
     }
 
-    EdgeCompare compare(Edge const &other) const
+    size_t head(size_t edge) const { return edges[edges[edge].next].tail; }
+
+    /**
+     * Add a facet with vertices A, B, and C (clockwise). The facet's twins are
+     * left unlinked.
+     */
+    size_t addFacet(size_t a, size_t b, size_t c)
     {
-        if (first == other.first && second == other.second)
-        {
-            return EdgeCompare::EQUAL;
-        }
-        else if (first == other.second && second == other.first)
-        {
-            return EdgeCompare::OPPOSITE;
-        }
-        else
-        {
-            return EdgeCompare::NOTEQUAL;
-        }
+        auto const f = facets.size();
+        auto const e = edges.size();
+        facets.push_back(Facet{
+            HalfPlane{points[a], points[b], points[c]},
+            e
+        });
+        edges.push_back(HalfEdge{a, NONE, e + 1, f});
+        edges.push_back(HalfEdge{b, NONE, e + 2, f});
+        edges.push_back(HalfEdge{c, NONE, e + 0, f});
+        return f;
     }
 
-    bool operator==(Edge const &o) const
+    void link(size_t e1, size_t e2)
     {
-        auto const c = compare(o);
-        return c == EdgeCompare::EQUAL || c == EdgeCompare::OPPOSITE;
+        edges[e1].twin = e2;
+        edges[e2].twin = e1;
     }
-};
 
-template<>
-struct std::hash<Edge>
-{
-    size_t operator()(Edge const &e) const
+    /**
+     * Find the horizon as seen from EYE, starting at facet F. F must be
+     * visible from EYE. Marks every facet visible from EYE and collects them
+     * in VISIBLE. Horizon edges belong to visible facets, and are collected
+     * in order so that each edge's head is the next edge's tail.
+     */
+    void findHorizon(
+        glm::vec3 const &eye,
+        size_t f,
+        std::vector<size_t> &horizon,
+        std::vector<size_t> &visible)
     {
-        std::hash<glm::vec3> const h{};
-        return h(e.first) ^ h(e.second);
+        _horizon_recurse(eye, NONE, f, horizon, visible);
     }
-};
 
-class ConvexHull
-{
-public:
-    std::unordered_set<HalfPlane> facets{};
-    std::unordered_map<HalfPlane, std::vector<Edge>> edges{};
-    std::unordered_map<HalfPlane, std::unordered_map<Edge, HalfPlane>>
-        neighbors{};
-
-    // Unless this is the first facet being added, B and C must make up an edge
-    // already in the hull.
-    void addFacet(glm::vec3 const &a, glm::vec3 const &b, glm::vec3 const &c)
+    /** Get planes of the hull's living facets. Coplanar facets are merged. */
+    std::vector<HalfPlane> as_planes() const
     {
-        auto const p = facets.emplace(a, b, c);
-        auto const newf = *p.first;
-        // Plane already exists in the hull.
-        if (!p.second)
-        {
-            _merge_existing_facet(newf, a, b, c);
-        }
-        // Plane does not already exist in the hull.
-        else
+        PlaneSet planes{facets.size()};
+        for (auto const &facet : facets)
         {
-            edges[newf] = {};
-            edges.at(newf).emplace_back(a, b);
-            edges.at(newf).emplace_back(b, c);
-            edges.at(newf).emplace_back(c, a);
+            if (facet.alive)
+            {
+                planes.insert(facet.plane);
+            }
         }
-        recalculateNeighbors();
+        return planes.values();
     }
 
-    void removeFacet(HalfPlane const &facet)
+    /** Get the points making up the hull. */
+    std::vector<glm::vec3> as_points() const
     {
-        facets.erase(facet);
-        edges.erase(facet);
-        neighbors.erase(facet);
-        // Erase references in the neighbors map.
-        for (auto &kv : neighbors)
+        std::vector<bool> used(points.size(), false);
+        for (auto const &facet : facets)
         {
-            for (auto it = kv.second.begin(); it != kv.second.end();)
+            if (!facet.alive)
             {
-                if (it->second == facet)
-                {
-                    it = kv.second.erase(it);
-                }
-                else
-                {
-                    it++;
-                }
+                continue;
             }
+            auto e = facet.edge;
+            do
+            {
+                used[edges[e].tail] = true;
+                e = edges[e].next;
+            } while (e != facet.edge);
         }
-    }
 
-    auto as_planes() const { return facets; }
-
-    auto as_points() const
-    {
-        std::unordered_set<glm::vec3> points{};
-        for (auto const &kv : edges)
+        std::vector<glm::vec3> out{};
+        for (size_t i = 0; i < points.size(); ++i)
         {
-            for (auto const &edge : kv.second)
+            if (used[i])
             {
-                points.insert(edge.first);
-                points.insert(edge.second);
+                out.push_back(points[i]);
             }
         }
-        return points;
+        return out;
     }
 
 #if !NDEBUG
     // for debugging
     bool checkIntegrity() const
     {
-        for (auto const &facet : facets)
+        for (size_t f = 0; f < facets.size(); ++f)
         {
-            // Every facet must have a neighbors map
-            assert(neighbors.count(facet) != 0);
-            // Every facet must have edges
-            assert(edges.count(facet) != 0);
-        }
-
-        // Edges must be ordered clockwise
-        for (auto const &kv : edges)
-        {
-            for (size_t i = 0; i + 1 < kv.second.size(); ++i)
+            if (!facets[f].alive)
             {
-                assert(kv.second.at(i).second == kv.second.at(i + 1).first);
+                continue;
             }
-            assert(kv.second.back().second == kv.second.front().first);
-        }
-
-        for (auto const &kv : edges)
-        {
-            for (auto const &edge : kv.second)
+            auto e = facets[f].edge;
+            do
             {
-                // Every edge must have a neighbor
-                assert(neighbors.at(kv.first).count(edge) != 0);
-                // All the neighbors must be in the hull
-                assert(neighbors.count(neighbors.at(kv.first).at(edge)) != 0);
-            }
+                auto const &edge = edges[e];
+                // Every edge must belong to its facet.
+                assert(edge.facet == f);
+                // Every edge must have a living neighbor.
+                assert(edge.twin != NONE);
+                assert(facets[edges[edge.twin].facet].alive);
+                // Twins must run in opposite directions.
+                assert(edges[edge.twin].twin == e);
+                assert(edges[edge.twin].tail == head(e));
+                e = edge.next;
+            } while (e != facets[f].edge);
         }
         return true;
     }
 #endif // !NDEBUG
 
 private:
-    // Splice new edges into an existing face
-    void _merge_existing_facet(
-        HalfPlane const &facet,
-        glm::vec3 const &a,
-        glm::vec3 const &b,
-        glm::vec3 const &c)
-    {
-        assert(facets.count(facet) != 0);
-
-        auto &e = edges.at(facet);
-        Edge const existing{c, b};
-
-        auto const replace = std::find(e.begin(), e.end(), existing);
-        assert(replace != e.end());
-
-        Edge const e1{existing.first, a};
-        Edge const e2{a, existing.second};
-
-        e.insert(e.erase(replace), {e1, e2});
-    }
-
-    // Find the edge between two planes.
-    std::optional<std::pair<Edge, Edge>> neighboring_edge(
-        HalfPlane const &a,
-        HalfPlane const &b) const
+    void _horizon_recurse(
+        glm::vec3 const &eye,
+        size_t crossed,
+        size_t f,
+        std::vector<size_t> &horizon,
+        std::vector<size_t> &visible)
     {
-        for (auto const &edge1 : edges.at(a))
+        facets[f].visible = true;
+        visible.push_back(f);
+
+        // Walk the facet's edges, starting just after the one we came in
+        // through, so the horizon comes out in order.
+        auto const stop = (crossed == NONE) ? facets[f].edge : crossed;
+        auto e = (crossed == NONE) ? facets[f].edge : edges[crossed].next;
+        do
         {
-            for (auto const &edge2 : edges.at(b))
+            auto const twin = edges[e].twin;
+            auto const neighbor = edges[twin].facet;
+            if (!facets[neighbor].visible)
             {
-                if (edge1.compare(edge2) == EdgeCompare::OPPOSITE)
+                if (facets[neighbor].plane.classify(eye) == ABOVE)
                 {
-                    return std::make_pair(edge1, edge2);
+                    _horizon_recurse(eye, twin, neighbor, horizon, visible);
                 }
-            }
-        }
-        return std::nullopt;
-    }
-
-    // Regenerare the `neighbors' map.
-    void recalculateNeighbors()
-    {
-        neighbors.clear();
-        for (auto const &f1 : facets)
-        {
-            for (auto const &f2 : facets)
-            {
-                if (f1 == f2)
-                {
-                    continue;
-                }
-
-                auto edges_pair = neighboring_edge(f1, f2);
-                if (edges_pair.has_value())
+                else
                 {
-                    assert(
-                        neighbors[f1].count(edges_pair->first) == 0
-                        || neighbors[f1][edges_pair->first] == f2);
-                    assert(
-                        neighbors[f2].count(edges_pair->second) == 0
-                        || neighbors[f2][edges_pair->second] == f1);
-                    neighbors[f1][edges_pair->first] = f2;
-                    neighbors[f2][edges_pair->second] = f1;
+                    horizon.push_back(e);
                 }
             }
-        }
+            e = edges[e].next;
+        } while (e != stop);
     }
 };
 
 /** Distance from X0 to the line between X1 and X2. */
-auto distance_to_line(glm::vec3 x0, glm::vec3 x1, glm::vec3 x2)
+static auto distance_to_line(glm::vec3 x0, glm::vec3 x1, glm::vec3 x2)
 {
     return glm::length(glm::cross(x0 - x1, x0 - x2)) / glm::length(x2 - x1);
 }
 
 // Helper for create_tetrahedron
-auto choose_minmax(std::vector<glm::vec3> const &vertices)
+static auto choose_minmax(std::vector<glm::vec3> const &vertices)
 {
     using VerticesIter = std::vector<glm::vec3>::const_iterator;
     using MinMaxT = std::pair<VerticesIter, VerticesIter>;
@@ -298,36 +266,39 @@ auto choose_minmax(std::vector<glm::vec3> const &vertices)
          { return glm::length(*e.second - *e.first); }](auto a, auto b)
         { return distance(a) < distance(b); });
 
-    return std::make_pair(*minmax->first, *minmax->second);
+    return std::make_pair(
+        static_cast<size_t>(minmax->first - vertices.cbegin()),
+        static_cast<size_t>(minmax->second - vertices.cbegin()));
 }
 
 /** Create a tetrahedron from given points. */
-auto create_tetrahedron(std::vector<glm::vec3> const &vertices)
+static void create_tetrahedron(ConvexHull &hull)
 {
+    auto const &vertices = hull.points;
     auto const minmax = choose_minmax(vertices);
-    auto const min = minmax.first, max = minmax.second;
+    auto const min = vertices[minmax.first], max = vertices[minmax.second];
 
     // Find point furthest from the line between the min and max.
     auto const linedist
         = [&min, &max](auto x) { return distance_to_line(x, min, max); };
-    auto const farL = *std::max_element(
+    auto const farL_it = std::max_element(
         vertices.cbegin(),
         vertices.cend(),
         [&linedist](auto a, auto b) { return linedist(a) < linedist(b); });
     // Degenerate case if this point is on the line.
-    if (glm::epsilonEqual(linedist(farL), 0.0f, HalfPlane::EPSILON))
+    if (glm::epsilonEqual(linedist(*farL_it), 0.0f, HalfPlane::EPSILON))
     {
         throw std::runtime_error{"create_tetrahedron degenerate case 1D"};
     }
 
     // Find point furthest from the plane formed by prior 3 points.
-    HalfPlane const plane{min, max, farL};
-    auto const farP = *std::max_element(
+    HalfPlane const plane{min, max, *farL_it};
+    auto const farP_it = std::max_element(
         vertices.cbegin(),
         vertices.cend(),
         [&plane](auto a, auto b)
         { return abs(plane.distanceTo(a)) < abs(plane.distanceTo(b)); });
-    auto const farD = plane.classify(farP);
+    auto const farD = plane.classify(*farP_it);
     // Degenerate case if this point is on the plane.
     if (farD == ON)
     {
@@ -335,128 +306,64 @@ auto create_tetrahedron(std::vector<glm::vec3> const &vertices)
     }
 
     // Create the tetrahedron. FARD's sign tells us clockwise vertex ordering.
-    auto const A = min;
-    auto const B = max;
-    auto const C = farL;
-    auto const D = farP;
-    ConvexHull out{};
+    auto const A = minmax.first;
+    auto const B = minmax.second;
+    auto const C = static_cast<size_t>(farL_it - vertices.cbegin());
+    auto const D = static_cast<size_t>(farP_it - vertices.cbegin());
     if (farD == BELOW)
     {
-        out.addFacet(A, B, C);
-        out.addFacet(D, B, A);
-        out.addFacet(D, C, B);
-        out.addFacet(D, A, C);
+        hull.addFacet(A, B, C);
+        hull.addFacet(D, B, A);
+        hull.addFacet(D, C, B);
+        hull.addFacet(D, A, C);
     }
     else
     {
-        out.addFacet(A, C, B);
-        out.addFacet(D, A, B);
-        out.addFacet(D, B, C);
-        out.addFacet(D, C, A);
+        hull.addFacet(A, C, B);
+        hull.addFacet(D, A, B);
+        hull.addFacet(D, B, C);
+        hull.addFacet(D, C, A);
     }
-    return out;
-}
-
-/** Find the points outside a convex hull. */
-auto get_outer_points(
-    ConvexHull const &hull,
-    std::vector<glm::vec3> const &points)
-{
-    std::vector<glm::vec3> outside{};
-    std::copy_if(
-        points.cbegin(),
-        points.cend(),
-        std::back_inserter(outside),
-        [&hull](auto p)
-        {
-            return std::any_of(
-                hull.facets.cbegin(),
-                hull.facets.cend(),
-                [&p](auto plane) { return plane.classify(p) == ABOVE; });
-        });
-    return outside;
-}
 
-/**
- * Maps points to visible facets. Each point is assigned to a single facet,
- * even if multiple are visible. A facet is visible to a point if the point is
- * above the facet.
- */
-auto get_conflict_lists(
-    ConvexHull const &hull,
-    std::vector<glm::vec3> const &points)
-{
-    std::unordered_map<HalfPlane, std::vector<glm::vec3>> conflicts{};
-    for (auto const &point : points)
+    // Link up the twins. Only 12 edges, so brute force is fine.
+    for (size_t e1 = 0; e1 < hull.edges.size(); ++e1)
     {
-        for (auto const &facet : hull.facets)
+        for (size_t e2 = e1 + 1; e2 < hull.edges.size(); ++e2)
         {
-            if (facet.classify(point) == ABOVE)
+            if (hull.edges[e1].tail == hull.head(e2)
+                && hull.edges[e2].tail == hull.head(e1))
             {
-                conflicts[facet].push_back(point);
-                break;
+                hull.link(e1, e2);
             }
         }
     }
-    return conflicts;
-}
-
-void dfs2(
-    ConvexHull const &hull,
-    glm::vec3 const &eye,
-    HalfPlane const &f,
-    std::unordered_set<HalfPlane> &visited,
-    std::vector<Edge> &horizon)
-{
-    visited.insert(f);
-    for (auto const &edge : hull.edges.at(f))
-    {
-        auto const &next = hull.neighbors.at(f).at(edge);
-        // Crossing this edge leads to a non-visible face, so this edge is on
-        // the horizon.
-        if (next.classify(eye) != ABOVE)
-        {
-            horizon.push_back(edge);
-        }
-        // If we haven't already visited the neighboring face, visit it.
-        else if (visited.count(next) == 0)
-        {
-            dfs2(hull, eye, next, visited, horizon);
-        }
-    }
-}
-
-auto dfs(ConvexHull const &hull, glm::vec3 const &eye, HalfPlane const &start)
-{
-    assert(start.classify(eye) == ABOVE);
-    std::unordered_set<HalfPlane> visited{};
-    std::vector<Edge> horizon{};
-    dfs2(hull, eye, start, visited, horizon);
-    return std::make_pair(horizon, visited);
 }
 
 /**
- * Find the list of edges on EYE's horizon.
- * A horizon edge is an edge between a visible facet and a non-visible facet.
+ * Assign each point in POINTS to the conflict list of the first facet in
+ * FACETS which it lies above. Points which aren't above any of the facets are
+ * inside the hull, and are dropped.
  */
-auto get_horizon(
-    glm::vec3 const &eye,
-    HalfPlane const &start,
-    ConvexHull const &facets)
+static void assign_conflicts(
+    ConvexHull &hull,
+    std::vector<size_t> const &points,
+    std::vector<size_t> const &facets)
 {
-    // run a depth-first search through the convexhull facets, using START as
-    // the root
-    auto const horizon_and_visible = dfs(facets, eye, start);
-    auto const horizon = horizon_and_visible.first;
-
-    // Check horizon is ordered clockwise
-    for (size_t i = 0; i < horizon.size() - 1; ++i)
+    PlaneBlock planes{};
+    planes.reserve(facets.size());
+    for (auto const f : facets)
     {
-        assert(horizon.at(i).second == horizon.at(i + 1).first);
+        planes.push_back(hull.facets[f].plane);
     }
-    assert(horizon.back().second == horizon.front().first);
 
-    return horizon_and_visible;
+    for (auto const point : points)
+    {
+        auto const i = first_above(planes, hull.points[point]);
+        if (i != facets.size())
+        {
+            hull.facets[facets[i]].conflicts.push_back(point);
+        }
+    }
 }
 
 /**
@@ -471,62 +378,102 @@ std::pair<std::vector<HalfPlane>, std::vector<glm::vec3>> facet_enumeration(
 
     assert(vertices.size() >= 4);
 
+    // Weld duplicate input points first, so the hull never has to deal with
+    // zero-area facets between them.
+    VertexSet welded{vertices.size()};
+    for (auto const &vertex : vertices)
+    {
+        welded.insert(vertex);
+    }
+    auto const &points = welded.values();
+    if (points.size() < 4)
+    {
+        throw std::runtime_error{"facet_enumeration degenerate case"};
+    }
+
     // Calculate starting tetrahedral hull.
-    auto convex_hull = create_tetrahedron(vertices);
+    ConvexHull convex_hull{points};
+    create_tetrahedron(convex_hull);
     assert(convex_hull.facets.size() == 4);
     assert(convex_hull.checkIntegrity());
 
-    auto outside_points = get_outer_points(convex_hull, vertices);
-    auto conflict_lists = get_conflict_lists(convex_hull, outside_points);
+    // Conflict lists are built once here, then only the points belonging to
+    // facets which get replaced are reassigned.
+    std::vector<size_t> all_points(points.size());
+    for (size_t i = 0; i < all_points.size(); ++i)
+    {
+        all_points[i] = i;
+    }
+    assign_conflicts(convex_hull, all_points, {0, 1, 2, 3});
 
-    while (!conflict_lists.empty())
+    std::vector<size_t> horizon{};
+    std::vector<size_t> visible{};
+    std::vector<size_t> new_facets{};
+    std::vector<size_t> orphans{};
+    for (size_t f = 0; f < convex_hull.facets.size(); ++f)
     {
-        // Find furthest conflicting point.
-        auto far = std::make_pair(
-            conflict_lists.cbegin()->first,
-            conflict_lists.cbegin()->second.at(0));
-        for (auto const &conflict : conflict_lists)
+        if (!convex_hull.facets[f].alive
+            || convex_hull.facets[f].conflicts.empty())
         {
-            auto const &f = conflict.first;
-            auto const &points = conflict.second;
+            continue;
+        }
+
+        // Find furthest conflicting point.
+        auto const &facet = convex_hull.facets[f];
+        auto const eye = *std::max_element(
+            facet.conflicts.cbegin(),
+            facet.conflicts.cend(),
+            [&facet, &points](auto a, auto b)
+            {
+                return facet.plane.distanceTo(points[a])
+                     < facet.plane.distanceTo(points[b]);
+            });
 
-            auto const furthest = *std::max_element(
-                points.cbegin(),
-                points.cend(),
-                [&f](auto a, auto b)
-                { return f.distanceTo(a) < f.distanceTo(b); });
+        horizon.clear();
+        visible.clear();
+        convex_hull.findHorizon(points[eye], f, horizon, visible);
 
-            if (far.first.distanceTo(far.second) < f.distanceTo(furthest))
+        // Remove the visible facets, holding on to their conflict points.
+        orphans.clear();
+        for (auto const v : visible)
+        {
+            auto &dead = convex_hull.facets[v];
+            dead.alive = false;
+            for (auto const point : dead.conflicts)
             {
-                far = std::make_pair(f, furthest);
+                if (point != eye)
+                {
+                    orphans.push_back(point);
+                }
             }
+            dead.conflicts.clear();
         }
 
-        auto const eye = far.second;
-        auto const facet = far.first;
-
-        auto const horizon_and_visible = get_horizon(eye, facet, convex_hull);
-        auto const horizon_edges = horizon_and_visible.first;
-        auto const visible_faces = horizon_and_visible.second;
-
-        for (auto const &face : visible_faces)
+        // Connect the eye to each horizon edge.
+        new_facets.clear();
+        for (auto const e : horizon)
         {
-            convex_hull.removeFacet(face);
+            auto const tail = convex_hull.edges[e].tail;
+            auto const head = convex_hull.head(e);
+            auto const twin = convex_hull.edges[e].twin;
+            auto const n = convex_hull.addFacet(tail, head, eye);
+            convex_hull.link(convex_hull.facets[n].edge, twin);
+            new_facets.push_back(n);
         }
-
-        for (auto const &edge : horizon_edges)
+        // Stitch the new facets to each other.
+        for (size_t i = 0; i < new_facets.size(); ++i)
         {
-            convex_hull.addFacet(eye, edge.first, edge.second);
+            auto const a = convex_hull.facets[new_facets[i]].edge;
+            auto const b
+                = convex_hull.facets[new_facets[(i + 1) % new_facets.size()]]
+                      .edge;
+            // a+1 runs head->eye, b+2 runs eye->tail.
+            convex_hull.link(a + 1, b + 2);
         }
 
+        assign_conflicts(convex_hull, orphans, new_facets);
         assert(convex_hull.checkIntegrity());
-        outside_points = get_outer_points(convex_hull, outside_points);
-        conflict_lists = get_conflict_lists(convex_hull, outside_points);
     }
 
-    auto const planes1 = convex_hull.as_planes();
-    std::vector<HalfPlane> const planes{planes1.cbegin(), planes1.cend()};
-    auto const points1 = convex_hull.as_points();
-    std::vector<glm::vec3> const points{points1.cbegin(), points1.cend()};
-    return std::make_pair(planes, points);
+    return std::make_pair(convex_hull.as_planes(), convex_hull.as_points());
 }
@@ -62,21 +62,12 @@ bool _cramer(glm::mat3 const &A, glm::vec3 const &d, glm::vec3 &x)
 }
 
 /** Test if X is on or inside the polygon defined by FACETS. */
-bool _is_point_in_polygon(
-    std::vector<HalfPlane> const &facets,
-    glm::vec3 const &x)
+bool _is_point_in_polygon(PlaneBlock const &facets, glm::vec3 const &x)
 {
-    for (auto const &f : facets)
-    {
-        if (f.classify(x) == ABOVE)
-        {
-            return false;
-        }
-    }
-    return true;
+    return first_above(facets, x) == facets.size();
 }
 
-std::unordered_set<glm::vec3> vertex_enumeration(
+std::vector<glm::vec3> vertex_enumeration(
     std::vector<HalfPlane> const &facets)
 {
     // Algorithm from
@@ -102,9 +93,13 @@ std::unordered_set<glm::vec3> vertex_enumeration(
     // [d2] + [a2 b2 c2] [x1 x2 x3] = [a2x1 b2x2 c2x3] >= 0
     // [..]   [   ..   ]              [      ..      ]
 
-    // This simplified method can produce duplicates, unordered_set is used to
-    // filter these out.
-    std::unordered_set<glm::vec3> vertices{};
+    // This simplified method can produce duplicates, and near-duplicates from
+    // rounding error. VertexSet is used to filter these out.
+    VertexSet vertices{facets.size() * 2};
+
+    // Every candidate vertex gets tested against all facets, so lay them out
+    // for batch classification once up front.
+    PlaneBlock const facets_block{facets};
 
     // Pick 3 facets.
     for (auto const &p0 : facets)
@@ -133,13 +128,13 @@ std::unordered_set<glm::vec3> vertex_enumeration(
                 // solution satisfies `b + A*x_bar >= 0`, output it.
                 if (_cramer(B, -b_bar, x_bar))
                 {
-                    if (_is_point_in_polygon(facets, x_bar))
+                    if (_is_point_in_polygon(facets_block, x_bar))
                     {
-                        vertices.emplace(x_bar);
+                        vertices.insert(x_bar);
                     }
                 }
             }
         }
     }
-    return vertices;
+    return vertices.values();
 }
@@ -0,0 +1,274 @@
+/**
+ * weldset.hpp - Epsilon-aware set for welding near-equal values.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_CONVEXHULL_WELDSET_HPP
+#define SE_CONVEXHULL_WELDSET_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/**
+ * Describes how a type is stored in a WeldSet. Specializations must provide:
+ * - `static constexpr size_t N`, the number of components;
+ * - `static constexpr float EPSILON`, the welding tolerance;
+ * - `static std::array<float, N> components(T const &)`.
+ */
+template<typename T>
+struct WeldTraits;
+
+/**
+ * Set of values where values whose components all lie within EPSILON of each
+ * other are considered the same value. Values are kept in insertion order,
+ * and the first value inserted is the one which is kept.
+ *
+ * Values are bucketed by snapping their components to a grid with cells
+ * 2*EPSILON across, so a value can only be welded to values in the same or
+ * directly adjacent cells. Lookups usually only need to check one cell.
+ */
+template<typename T, typename Traits = WeldTraits<T>>
+class WeldSet
+{
+public:
+    static constexpr size_t N = Traits::N;
+
+    WeldSet() = default;
+
+    explicit WeldSet(size_t expected)
+    {
+        reserve(expected);
+    }
+
+    /**
+     * Insert VALUE, unless an equivalent value is already in the set.
+     *
+     * @return The index of VALUE, or of the value it was welded to, and
+     *         whether VALUE was inserted.
+     */
+    std::pair<size_t, bool> insert(T const &value)
+    {
+        auto const components = Traits::components(value);
+        if (auto const existing = _find(components))
+        {
+            return {existing.value(), false};
+        }
+
+        if ((_values.size() + 1) * 2 > _slots.size())
+        {
+            _rehash(std::max<size_t>(16, _slots.size() * 2));
+        }
+
+        auto const index = static_cast<uint32_t>(_values.size());
+        auto const cell = _cell_of(components);
+        _values.push_back(value);
+        _components.push_back(components);
+        _cells.push_back(cell);
+        _place(index, _hash(cell));
+        return {index, true};
+    }
+
+    /** Get the index of the value equivalent to VALUE, if there is one. */
+    std::optional<size_t> find(T const &value) const
+    {
+        return _find(Traits::components(value));
+    }
+
+    /** Check if the set contains a value equivalent to VALUE. */
+    bool contains(T const &value) const
+    {
+        return find(value).has_value();
+    }
+
+    /** Get values, in the order they were inserted. */
+    std::vector<T> const &values() const { return _values; }
+
+    size_t size() const { return _values.size(); }
+
+    bool empty() const { return _values.empty(); }
+
+    void reserve(size_t count)
+    {
+        _values.reserve(count);
+        _components.reserve(count);
+        _cells.reserve(count);
+        size_t capacity = 16;
+        while (capacity < count * 2)
+        {
+            capacity *= 2;
+        }
+        if (capacity > _slots.size())
+        {
+            _rehash(capacity);
+        }
+    }
+
+    void clear()
+    {
+        _values.clear();
+        _components.clear();
+        _cells.clear();
+        std::fill(_slots.begin(), _slots.end(), EMPTY);
+    }
+
+private:
+    using Components = std::array<float, N>;
+    using Cell = std::array<int64_t, N>;
+
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+    static constexpr float CELL_SIZE_INV = 0.5f / Traits::EPSILON;
+
+    std::vector<T> _values{};
+    std::vector<Components> _components{};
+    std::vector<Cell> _cells{};
+    /// Open-addressed (linear probing) table of indices into _values.
+    std::vector<uint32_t> _slots{};
+
+    static int64_t _snap(float x)
+    {
+        return static_cast<int64_t>(std::floor(x * CELL_SIZE_INV));
+    }
+
+    static Cell _cell_of(Components const &components)
+    {
+        Cell cell{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            cell[i] = _snap(components[i]);
+        }
+        return cell;
+    }
+
+    /**
+     * Hash a grid cell. Each coordinate is folded in with a multiply and
+     * rotate, then the result is run through the splitmix64 finalizer so that
+     * neighboring and permuted cells land in unrelated slots.
+     */
+    static uint64_t _hash(Cell const &cell)
+    {
+        uint64_t h = 0x9E3779B97F4A7C15ull;
+        for (auto const c : cell)
+        {
+            h ^= static_cast<uint64_t>(c);
+            h *= 0xFF51AFD7ED558CCDull;
+            h = (h << 31) | (h >> 33);
+        }
+        h ^= h >> 30;
+        h *= 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 27;
+        h *= 0x94D049BB133111EBull;
+        h ^= h >> 31;
+        return h;
+    }
+
+    static bool _equivalent(Components const &a, Components const &b)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            if (!(std::abs(a[i] - b[i]) < Traits::EPSILON))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void _place(uint32_t index, uint64_t hash)
+    {
+        auto const mask = _slots.size() - 1;
+        auto slot = hash & mask;
+        while (_slots[slot] != EMPTY)
+        {
+            slot = (slot + 1) & mask;
+        }
+        _slots[slot] = index;
+    }
+
+    void _rehash(size_t capacity)
+    {
+        _slots.assign(capacity, EMPTY);
+        for (uint32_t i = 0; i < _values.size(); ++i)
+        {
+            _place(i, _hash(_cells[i]));
+        }
+    }
+
+    std::optional<size_t> _find_in_cell(
+        Cell const &cell,
+        Components const &components) const
+    {
+        auto const mask = _slots.size() - 1;
+        for (auto slot = _hash(cell) & mask; _slots[slot] != EMPTY;
+             slot = (slot + 1) & mask)
+        {
+            auto const index = _slots[slot];
+            if (_cells[index] == cell
+                && _equivalent(_components[index], components))
+            {
+                return index;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<size_t> _find(Components const &components) const
+    {
+        if (_values.empty())
+        {
+            return std::nullopt;
+        }
+
+        // Anything within EPSILON lies in one of at most two cells per
+        // component. Visit every combination of them.
+        Cell lo{}, hi{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            lo[i] = _snap(components[i] - Traits::EPSILON);
+            hi[i] = _snap(components[i] + Traits::EPSILON);
+        }
+
+        Cell cell = lo;
+        while (true)
+        {
+            if (auto const found = _find_in_cell(cell, components))
+            {
+                return found;
+            }
+
+            size_t i = 0;
+            for (; i < N; ++i)
+            {
+                if (cell[i] < hi[i])
+                {
+                    cell[i]++;
+                    break;
+                }
+                cell[i] = lo[i];
+            }
+            if (i == N)
+            {
+                return std::nullopt;
+            }
+        }
+    }
+};
+
+#endif
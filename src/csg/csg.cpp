@@ -0,0 +1,309 @@
+/**
+ * csg.cpp - Constructive solid geometry on convex solids.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "csg.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace CSG;
+
+/** Get the plane facing the opposite way. */
+static HalfPlane flipped(HalfPlane const &plane)
+{
+    return {-plane.a, -plane.b, -plane.c, -plane.d};
+}
+
+/** Check if two bounding boxes overlap by more than EPSILON. */
+static bool bounds_overlap(Solid const &a, Solid const &b)
+{
+    for (glm::length_t i = 0; i < 3; ++i)
+    {
+        if (a.maxs[i] - HalfPlane::EPSILON <= b.mins[i]
+            || b.maxs[i] - HalfPlane::EPSILON <= a.mins[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Check if two bounding boxes overlap or touch. */
+static bool bounds_touch(Solid const &a, Solid const &b)
+{
+    for (glm::length_t i = 0; i < 3; ++i)
+    {
+        if (a.maxs[i] + HalfPlane::EPSILON < b.mins[i]
+            || b.maxs[i] + HalfPlane::EPSILON < a.mins[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Sides of both A and B, ie. the sides of their intersection. */
+static std::vector<Side> combined_sides(Solid const &a, Solid const &b)
+{
+    std::vector<Side> sides{};
+    sides.reserve(a.sides.size() + b.sides.size());
+    sides.insert(sides.end(), a.sides.cbegin(), a.sides.cend());
+    sides.insert(sides.end(), b.sides.cbegin(), b.sides.cend());
+    return sides;
+}
+
+std::optional<Solid> CSG::make_solid(std::vector<Side> const &sides)
+{
+    // Duplicate planes would produce duplicate faces.
+    PlaneSet planes{sides.size()};
+    std::vector<size_t> tags{};
+    for (auto const &side : sides)
+    {
+        if (planes.insert(side.plane).second)
+        {
+            tags.push_back(side.tag);
+        }
+    }
+    if (planes.size() < 4)
+    {
+        return std::nullopt;
+    }
+
+    auto const windings = face_enumeration(planes.values());
+    Solid solid{};
+    for (size_t i = 0; i < windings.size(); ++i)
+    {
+        if (!windings[i].empty())
+        {
+            solid.sides.push_back(
+                Side{planes.values()[i], tags[i], windings[i]});
+        }
+    }
+    if (solid.sides.size() < 4)
+    {
+        return std::nullopt;
+    }
+
+    // Sides which face each other across a gap thinner than EPSILON still
+    // produce polygons, so make sure the solid actually has some thickness
+    // behind every side.
+    auto const points = corners(solid);
+    PointBlock const block{points};
+    std::vector<Classification> sides_of(points.size());
+    for (auto const &side : solid.sides)
+    {
+        classify(side.plane, block, sides_of.data());
+        if (std::find(sides_of.cbegin(), sides_of.cend(), BELOW)
+            == sides_of.cend())
+        {
+            return std::nullopt;
+        }
+    }
+
+    solid.mins = solid.maxs = points.front();
+    for (auto const &point : points)
+    {
+        solid.mins = glm::min(solid.mins, point);
+        solid.maxs = glm::max(solid.maxs, point);
+    }
+    return solid;
+}
+
+std::vector<glm::vec3> CSG::corners(Solid const &solid)
+{
+    std::vector<glm::vec3> points{};
+    for (auto const &side : solid.sides)
+    {
+        points.insert(points.end(), side.polygon.cbegin(), side.polygon.cend());
+    }
+    return points;
+}
+
+double CSG::volume(Solid const &solid)
+{
+    // Sum the signed volumes of the tetrahedra formed by the origin and a fan
+    // triangulation of each side.
+    double sum = 0.0;
+    for (auto const &side : solid.sides)
+    {
+        glm::dvec3 const p0{side.polygon.at(0)};
+        for (size_t i = 1; i + 1 < side.polygon.size(); ++i)
+        {
+            glm::dvec3 const p1{side.polygon[i]};
+            glm::dvec3 const p2{side.polygon[i + 1]};
+            sum += glm::dot(p0, glm::cross(p1, p2));
+        }
+    }
+    return sum / 6.0;
+}
+
+bool CSG::intersects(Solid const &a, Solid const &b)
+{
+    if (!bounds_overlap(a, b))
+    {
+        return false;
+    }
+    return make_solid(combined_sides(a, b)).has_value();
+}
+
+std::pair<std::optional<Solid>, std::optional<Solid>> CSG::split(
+    Solid const &solid,
+    HalfPlane const &plane,
+    size_t tag)
+{
+    auto const points = corners(solid);
+    std::vector<Classification> sides_of(points.size());
+    classify(plane, PointBlock{points}, sides_of.data());
+    auto const has = [&sides_of](Classification c)
+    {
+        return std::find(sides_of.cbegin(), sides_of.cend(), c)
+            != sides_of.cend();
+    };
+
+    // Skip the clipping if the plane doesn't cut through the solid.
+    if (!has(ABOVE))
+    {
+        return {solid, std::nullopt};
+    }
+    if (!has(BELOW))
+    {
+        return {std::nullopt, solid};
+    }
+
+    auto sides = solid.sides;
+    sides.push_back(Side{plane, tag});
+    auto below = make_solid(sides);
+    sides.back().plane = flipped(plane);
+    auto above = make_solid(sides);
+    return {below, above};
+}
+
+std::vector<Solid> CSG::subtract(Solid const &solid, Solid const &cutter)
+{
+    if (!intersects(solid, cutter))
+    {
+        return {solid};
+    }
+
+    // Peel off the part of the solid in front of each of the cutter's sides.
+    // Whatever is left at the end is inside the cutter, and gets thrown away.
+    std::vector<Solid> pieces{};
+    auto remaining = solid;
+    for (auto const &side : cutter.sides)
+    {
+        auto [below, above] = split(remaining, side.plane, side.tag);
+        if (above)
+        {
+            pieces.push_back(std::move(above.value()));
+        }
+        if (!below)
+        {
+            break;
+        }
+        remaining = std::move(below.value());
+    }
+    return pieces;
+}
+
+std::vector<Solid> CSG::hollow(Solid const &solid, float thickness)
+{
+    if (!(thickness > 0.0f))
+    {
+        throw std::invalid_argument{"hollow thickness must be positive"};
+    }
+
+    // Since sides have unit normals, increasing D moves the plane inwards by
+    // that much.
+    std::vector<Side> inner_sides{};
+    for (auto const &side : solid.sides)
+    {
+        auto plane = side.plane;
+        plane.d += thickness;
+        inner_sides.push_back(Side{plane, side.tag});
+    }
+
+    auto const inner = make_solid(inner_sides);
+    if (!inner)
+    {
+        return {};
+    }
+    return subtract(solid, inner.value());
+}
+
+std::optional<Solid> CSG::merge(Solid const &a, Solid const &b)
+{
+    if (!bounds_touch(a, b))
+    {
+        return std::nullopt;
+    }
+
+    auto points = corners(a);
+    auto const b_points = corners(b);
+    points.insert(points.end(), b_points.cbegin(), b_points.cend());
+
+    std::vector<HalfPlane> hull{};
+    try
+    {
+        hull = facet_enumeration(points).first;
+    }
+    catch (std::runtime_error const &)
+    {
+        return std::nullopt;
+    }
+
+    // If the union is convex, it is its own hull, so every side of the hull
+    // must lie on a side of one of the inputs.
+    std::vector<Side> sides{};
+    for (auto const &plane : hull)
+    {
+        auto const matches = [&plane](Side const &side)
+        { return side.plane == plane; };
+        auto it = std::find_if(a.sides.cbegin(), a.sides.cend(), matches);
+        if (it == a.sides.cend())
+        {
+            it = std::find_if(b.sides.cbegin(), b.sides.cend(), matches);
+            if (it == b.sides.cend())
+            {
+                return std::nullopt;
+            }
+        }
+        sides.push_back(Side{plane, it->tag});
+    }
+
+    auto merged = make_solid(sides);
+    if (!merged)
+    {
+        return std::nullopt;
+    }
+
+    // That alone doesn't rule out a gap between the solids, eg. two boxes
+    // lined up with some space in between. The hull must not add volume.
+    double overlap = 0.0;
+    if (auto const both = make_solid(combined_sides(a, b)))
+    {
+        overlap = volume(both.value());
+    }
+    auto const expected = volume(a) + volume(b) - overlap;
+    auto const tolerance = std::max(1e-3, std::abs(expected) * 1e-4);
+    if (std::abs(volume(merged.value()) - expected) > tolerance)
+    {
+        return std::nullopt;
+    }
+    return merged;
+}
@@ -0,0 +1,125 @@
+/**
+ * csg.hpp - Constructive solid geometry on convex solids.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_CSG_HPP
+#define SE_CSG_HPP
+
+#include <convexhull/convexhull.hpp>
+
+#include <glm/glm.hpp>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace CSG
+{
+    /** Tag for sides which weren't derived from any input side. */
+    constexpr size_t NEW_SIDE = static_cast<size_t>(-1);
+
+    /** One side of a convex solid. */
+    struct Side
+    {
+        /** The solid lies below this plane. */
+        HalfPlane plane;
+        /**
+         * Caller-defined identifier. Carried through CSG operations, so that
+         * callers can track which input face a side came from (eg. to copy
+         * its texture).
+         */
+        size_t tag{NEW_SIDE};
+        /**
+         * The side's polygon, ordered counterclockwise when viewed from
+         * outside the solid. Filled in by make_solid().
+         */
+        std::vector<glm::vec3> polygon{};
+    };
+
+    /**
+     * Convex solid, made up of the space below all of its sides' planes.
+     * Get these from make_solid(), which guarantees the solid has volume and
+     * that every side actually touches it.
+     */
+    struct Solid
+    {
+        std::vector<Side> sides{};
+        /** Bounding box. */
+        glm::vec3 mins{0.0f}, maxs{0.0f};
+    };
+
+    /**
+     * Build a solid from a set of sides. Sides which don't touch the solid
+     * are dropped, as are duplicates.
+     *
+     * @param sides Planes of the solid. Polygons are ignored.
+     * @return The solid, or nothing if the sides don't enclose any volume.
+     */
+    std::optional<Solid> make_solid(std::vector<Side> const &sides);
+
+    /** Get every corner of SOLID. Corners may appear more than once. */
+    std::vector<glm::vec3> corners(Solid const &solid);
+
+    /** Calculate the volume of SOLID. */
+    double volume(Solid const &solid);
+
+    /**
+     * Check if two solids overlap. Solids which only touch along a face,
+     * edge, or corner do not overlap.
+     */
+    bool intersects(Solid const &a, Solid const &b);
+
+    /**
+     * Cut SOLID in two along PLANE.
+     *
+     * @param tag Tag for the new sides created by the cut.
+     * @return The parts of the solid below and above the plane. A part is
+     *         empty if the solid doesn't extend to that side of the plane.
+     */
+    std::pair<std::optional<Solid>, std::optional<Solid>> split(
+        Solid const &solid,
+        HalfPlane const &plane,
+        size_t tag = NEW_SIDE);
+
+    /**
+     * Carve CUTTER out of SOLID.
+     *
+     * @return Convex pieces which together make up the remains of SOLID. If
+     *         the solids don't overlap, this is just SOLID.
+     */
+    std::vector<Solid> subtract(Solid const &solid, Solid const &cutter);
+
+    /**
+     * Hollow out SOLID, leaving walls THICKNESS units thick. The inner side of
+     * each wall has the same tag as the outer side it is parallel to.
+     *
+     * @return Convex pieces making up the walls, or nothing if the solid is
+     *         too thin to hollow.
+     * @throw std::invalid_argument if THICKNESS is not positive.
+     */
+    std::vector<Solid> hollow(Solid const &solid, float thickness);
+
+    /**
+     * Merge two solids into one, if their union is convex. Sides of the
+     * result keep the tags of the input sides they lie on.
+     *
+     * @return The merged solid, or nothing if the union is not convex.
+     */
+    std::optional<Solid> merge(Solid const &a, Solid const &b);
+} // namespace CSG
+
+#endif
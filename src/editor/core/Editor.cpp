@@ -75,6 +75,8 @@ void Editor::on_object_selected_changed(EditorObjectRef const &obj)
 
 void Editor::on_object_added(EditorObjectRef const &obj)
 {
+    texture_usage.add(obj);
+
     // obj will be automatically added/removed from Selection.
     obj->property_selected().signal_changed().connect(sigc::bind(
         sigc::mem_fun(*this, &Editor::on_object_selected_changed),
@@ -93,6 +95,7 @@ void Editor::_on_map_changed()
     brushbox.p1(glm::vec3{});
     brushbox.p2(glm::vec3{});
     selected.clear();
+    texture_usage.clear();
 
     auto world = get_map();
     on_object_added(world);
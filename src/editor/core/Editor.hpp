@@ -22,6 +22,7 @@
 #include "BrushBox.hpp"
 #include "MapTools.hpp"
 #include "Selection.hpp"
+#include "TextureUsage.hpp"
 
 #include <editor/world/EditorWorld.hpp>
 #include <se-lua/utils/Referenceable.hpp>
@@ -59,6 +60,8 @@ namespace Sickle::Editor
         BrushBox brushbox{};
         /** Selected brushes/entities. */
         Selection selected{};
+        /** Which faces use each texture. */
+        TextureUsage texture_usage{};
 
         std::shared_ptr<OperationLoader> oploader{nullptr};
 
@@ -0,0 +1,165 @@
+/**
+ * TextureUsage.cpp - Index of faces by texture.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TextureUsage.hpp"
+
+using namespace Sickle::Editor;
+
+void TextureUsage::add(EditorObjectRef const &obj)
+{
+    _add_one(obj);
+    for (auto const &child : obj->children_recursive())
+    {
+        _add_one(child);
+    }
+}
+
+void TextureUsage::remove(EditorObject *obj)
+{
+    // Children aren't told when their ancestor leaves the world, so they
+    // have to be removed here too.
+    for (auto const &child : obj->children_recursive())
+    {
+        _remove_one(child.get());
+    }
+    _remove_one(obj);
+}
+
+void TextureUsage::clear()
+{
+    for (auto &[obj, connection] : _objects)
+    {
+        connection.disconnect();
+    }
+    for (auto &[face, tracked] : _faces)
+    {
+        tracked.texture_changed.disconnect();
+    }
+    _objects.clear();
+    _faces.clear();
+    _by_texture.clear();
+}
+
+std::vector<FaceRef> TextureUsage::get_faces(
+    Textures::TextureId texture) const
+{
+    std::vector<FaceRef> faces{};
+    if (texture.index() < _by_texture.size())
+    {
+        auto const &users = _by_texture[texture.index()];
+        faces.reserve(users.size());
+        for (auto const face : users)
+        {
+            faces.push_back(_faces.at(face).face);
+        }
+    }
+    return faces;
+}
+
+size_t TextureUsage::count(Textures::TextureId texture) const
+{
+    if (texture.index() < _by_texture.size())
+    {
+        return _by_texture[texture.index()].size();
+    }
+    return 0;
+}
+
+std::vector<Textures::TextureId> TextureUsage::get_textures() const
+{
+    std::vector<Textures::TextureId> textures{};
+    for (uint32_t i = 0; i < _by_texture.size(); ++i)
+    {
+        if (!_by_texture[i].empty())
+        {
+            textures.push_back(Textures::TextureId::from_index(i));
+        }
+    }
+    return textures;
+}
+
+void TextureUsage::_add_one(EditorObjectRef const &obj)
+{
+    if (_objects.count(obj.get()))
+    {
+        return;
+    }
+    // Bind a raw pointer, since a reference held by the object's own signal
+    // would keep it alive forever.
+    _objects[obj.get()] = obj->signal_removed().connect(sigc::bind(
+        sigc::mem_fun(*this, &TextureUsage::remove),
+        obj.get()));
+
+    auto const face = FaceRef::cast_dynamic(obj);
+    if (!face)
+    {
+        return;
+    }
+    auto const texture = face->get_texture();
+    _faces.emplace(
+        face.get(),
+        TrackedFace{
+            face,
+            texture,
+            face->property_texture().signal_changed().connect(sigc::bind(
+                sigc::mem_fun(*this, &TextureUsage::_on_texture_changed),
+                face.get()))});
+    _link(face.get(), texture);
+}
+
+void TextureUsage::_remove_one(EditorObject *obj)
+{
+    auto const it = _objects.find(obj);
+    if (it == _objects.end())
+    {
+        return;
+    }
+    it->second.disconnect();
+    _objects.erase(it);
+
+    auto const face = _faces.find(dynamic_cast<Face *>(obj));
+    if (face != _faces.end())
+    {
+        face->second.texture_changed.disconnect();
+        _unlink(face->first, face->second.texture);
+        _faces.erase(face);
+    }
+}
+
+void TextureUsage::_on_texture_changed(Face *face)
+{
+    auto &tracked = _faces.at(face);
+    auto const texture = face->get_texture();
+    _unlink(face, tracked.texture);
+    _link(face, texture);
+    tracked.texture = texture;
+}
+
+void TextureUsage::_link(Face *face, Textures::TextureId texture)
+{
+    if (texture.index() >= _by_texture.size())
+    {
+        _by_texture.resize(texture.index() + 1);
+    }
+    _by_texture[texture.index()].insert(face);
+}
+
+void TextureUsage::_unlink(Face *face, Textures::TextureId texture)
+{
+    _by_texture[texture.index()].erase(face);
+}
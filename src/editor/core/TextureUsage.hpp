@@ -0,0 +1,114 @@
+/**
+ * TextureUsage.hpp - Index of faces by texture.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_EDITOR_TEXTUREUSAGE_HPP
+#define SE_EDITOR_TEXTUREUSAGE_HPP
+
+#include <editor/textures/TextureId.hpp>
+#include <editor/world/EditorWorld.hpp>
+
+#include <sigc++/sigc++.h>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Sickle::Editor
+{
+    /**
+     * Index of which faces use each texture.
+     *
+     * Answers "which faces use texture X?" in time proportional to the
+     * answer, instead of walking the whole world. Objects are added as they
+     * enter the world, and their faces are kept in the index until the
+     * object is removed. Faces are re-indexed when their texture changes.
+     */
+    class TextureUsage : public sigc::trackable
+    {
+    public:
+        TextureUsage() = default;
+
+        /**
+         * Index an object and all its children. Adding an object twice has
+         * no effect.
+         *
+         * @param obj The object to add.
+         */
+        void add(EditorObjectRef const &obj);
+
+        /**
+         * Remove an object and all its children from the index.
+         *
+         * @param obj The object to remove.
+         */
+        void remove(EditorObject *obj);
+
+        /**
+         * Remove everything from the index.
+         */
+        void clear();
+
+        /**
+         * Get the faces using a texture.
+         *
+         * @param texture The texture.
+         * @return Every indexed face using the texture, in no particular
+         *         order.
+         */
+        std::vector<FaceRef> get_faces(Textures::TextureId texture) const;
+
+        /**
+         * Count the faces using a texture.
+         *
+         * @param texture The texture.
+         * @return The number of indexed faces using the texture.
+         */
+        size_t count(Textures::TextureId texture) const;
+
+        /**
+         * Get the textures used by at least one face.
+         *
+         * @return The textures in use, in no particular order.
+         */
+        std::vector<Textures::TextureId> get_textures() const;
+
+    private:
+        struct TrackedFace
+        {
+            FaceRef face;
+            Textures::TextureId texture;
+            sigc::connection texture_changed;
+        };
+
+        std::unordered_map<EditorObject *, sigc::connection> _objects{};
+        std::unordered_map<Face *, TrackedFace> _faces{};
+        // Indexed by TextureId.
+        std::vector<std::unordered_set<Face *>> _by_texture{};
+
+        TextureUsage(TextureUsage const &) = delete;
+        TextureUsage &operator=(TextureUsage const &) = delete;
+
+        void _add_one(EditorObjectRef const &obj);
+        void _remove_one(EditorObject *obj);
+        void _on_texture_changed(Face *face);
+        void _link(Face *face, Textures::TextureId texture);
+        void _unlink(Face *face, Textures::TextureId texture);
+    };
+} // namespace Sickle::Editor
+
+#endif
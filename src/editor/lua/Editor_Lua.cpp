@@ -61,6 +61,97 @@ static int remove_brush(lua_State *L)
     return 0;
 }
 
+/** Get a table of brushes from the Lua stack. */
+static std::vector<BrushRef> check_brushes(lua_State *L, int arg)
+{
+    luaL_checktype(L, arg, LUA_TTABLE);
+    std::vector<BrushRef> brushes{};
+    auto const n = luaL_len(L, arg);
+    for (lua_Integer i = 1; i <= n; ++i)
+    {
+        lua_geti(L, arg, i);
+        brushes.push_back(leditorbrush_check(L, -1));
+        lua_pop(L, 1);
+    }
+    return brushes;
+}
+
+static int clip_brushes(lua_State *L)
+{
+    static char const *const keep_options[] = {"below", "above", "both", NULL};
+    static World::ClipKeep const keep_values[] = {
+        World::ClipKeep::BELOW,
+        World::ClipKeep::ABOVE,
+        World::ClipKeep::BOTH};
+
+    auto ed = leditor_check(L, 1);
+    auto const brushes = check_brushes(L, 2);
+    auto const point = lgeo_checkvector<glm::vec3>(L, 3);
+    auto const normal = glm::normalize(lgeo_checkvector<glm::vec3>(L, 4));
+    auto const keep = luaL_checkoption(L, 5, "both", keep_options);
+
+    HalfPlane const plane{
+        normal.x,
+        normal.y,
+        normal.z,
+        -glm::dot(normal, point)};
+    try
+    {
+        ed->get_map()->clip_brushes(brushes, plane, keep_values[keep]);
+    }
+    catch (std::runtime_error const &e)
+    {
+        return luaL_error(L, "%s", e.what());
+    }
+    return 0;
+}
+
+static int carve(lua_State *L)
+{
+    auto ed = leditor_check(L, 1);
+    auto const cutters = check_brushes(L, 2);
+    try
+    {
+        ed->get_map()->carve(cutters);
+    }
+    catch (std::runtime_error const &e)
+    {
+        return luaL_error(L, "%s", e.what());
+    }
+    return 0;
+}
+
+static int hollow_brushes(lua_State *L)
+{
+    auto ed = leditor_check(L, 1);
+    auto const brushes = check_brushes(L, 2);
+    auto const thickness = static_cast<float>(luaL_checknumber(L, 3));
+    try
+    {
+        ed->get_map()->hollow_brushes(brushes, thickness);
+    }
+    catch (std::exception const &e)
+    {
+        return luaL_error(L, "%s", e.what());
+    }
+    return 0;
+}
+
+static int merge_brushes(lua_State *L)
+{
+    auto ed = leditor_check(L, 1);
+    auto const brushes = check_brushes(L, 2);
+    try
+    {
+        ed->get_map()->merge_brushes(brushes);
+    }
+    catch (std::runtime_error const &e)
+    {
+        return luaL_error(L, "%s", e.what());
+    }
+    return 0;
+}
+
 static int add_entity(lua_State *L)
 {
     auto const ed = leditor_check(L, 1);
@@ -152,6 +243,38 @@ static int get_brushbox(lua_State *L)
     return 1;
 }
 
+static int get_faces_with_texture(lua_State *L)
+{
+    auto ed = leditor_check(L, 1);
+    // A name which was never interned can't be on any face.
+    auto const texture = Textures::TextureId::find(luaL_checkstring(L, 2));
+    lua_newtable(L);
+    if (!texture)
+    {
+        return 1;
+    }
+    lua_Integer i = 1;
+    for (auto const &face : ed->texture_usage.get_faces(*texture))
+    {
+        Lua::push(L, face);
+        lua_seti(L, -2, i++);
+    }
+    return 1;
+}
+
+static int get_used_textures(lua_State *L)
+{
+    auto ed = leditor_check(L, 1);
+    lua_newtable(L);
+    lua_Integer i = 1;
+    for (auto const &texture : ed->texture_usage.get_textures())
+    {
+        Lua::push(L, texture.name());
+        lua_seti(L, -2, i++);
+    }
+    return 1;
+}
+
 static int get_mode(lua_State *L)
 {
     auto ed = leditor_check(L, 1);
@@ -165,20 +288,26 @@ static int do_nothing(lua_State *L)
 }
 
 static luaL_Reg methods[] = {
-    {     "add_brush",     add_brush},
-    {  "remove_brush",  remove_brush},
-    {    "add_entity",    add_entity},
-    { "remove_entity", remove_entity},
-    { "remove_object", remove_object},
-    {  "do_operation",  do_operation},
-    {  "matches_mode",  matches_mode},
-
-    { "get_selection", get_selection},
-    {  "get_brushbox",  get_brushbox},
-    {      "get_mode",      get_mode},
-
-    {"on_map_changed",    do_nothing},
-    {            NULL,          NULL}
+    {             "add_brush",              add_brush},
+    {          "remove_brush",           remove_brush},
+    {          "clip_brushes",           clip_brushes},
+    {                 "carve",                  carve},
+    {        "hollow_brushes",         hollow_brushes},
+    {         "merge_brushes",          merge_brushes},
+    {            "add_entity",             add_entity},
+    {         "remove_entity",          remove_entity},
+    {         "remove_object",          remove_object},
+    {          "do_operation",           do_operation},
+    {          "matches_mode",           matches_mode},
+
+    {         "get_selection",          get_selection},
+    {          "get_brushbox",           get_brushbox},
+    {"get_faces_with_texture", get_faces_with_texture},
+    {     "get_used_textures",      get_used_textures},
+    {              "get_mode",               get_mode},
+
+    {        "on_map_changed",             do_nothing},
+    {                    NULL,                   NULL}
 };
 
 ////////////////////////////////////////////////////////////////////////////////
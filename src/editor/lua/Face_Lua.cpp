@@ -38,7 +38,7 @@ static int is_selected(lua_State *L)
 static int get_texture(lua_State *L)
 {
     auto const f = lface_check(L, 1);
-    Lua::push(L, f->get_texture());
+    Lua::push(L, f->get_texture().name());
     return 1;
 }
 
@@ -95,7 +95,7 @@ static int set_texture(lua_State *L)
 {
     auto const f = lface_check(L, 1);
     auto const t = luaL_checkstring(L, 2);
-    f->set_texture(t);
+    f->set_texture(Textures::TextureId{t});
     return 0;
 }
 
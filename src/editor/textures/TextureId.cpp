@@ -0,0 +1,113 @@
+/**
+ * TextureId.cpp - Interned texture names.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TextureId.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace Sickle::Editor::Textures;
+
+/** The global intern table. */
+struct InternTable
+{
+    std::mutex mutex{};
+    // Deque, so references to names survive growth.
+    std::deque<std::string> names{""};
+    // Keyed by the lowercased name.
+    std::unordered_map<std::string, uint32_t> indices{{"", 0}};
+};
+
+static InternTable &intern_table()
+{
+    static InternTable the_table{};
+    return the_table;
+}
+
+/** Names are case-insensitive, so the table is keyed by lowercase names. */
+static std::string make_key(std::string_view name)
+{
+    std::string key{name};
+    std::transform(
+        key.begin(),
+        key.end(),
+        key.begin(),
+        [](unsigned char c) { return std::tolower(c); });
+    return key;
+}
+
+TextureId::TextureId(std::string_view name)
+{
+    auto key = make_key(name);
+
+    auto &table = intern_table();
+    std::lock_guard lock{table.mutex};
+    auto const [it, inserted] = table.indices.try_emplace(
+        std::move(key),
+        static_cast<uint32_t>(table.names.size()));
+    if (inserted)
+    {
+        table.names.emplace_back(name);
+    }
+    _index = it->second;
+}
+
+std::optional<TextureId> TextureId::find(std::string_view name)
+{
+    auto const key = make_key(name);
+
+    auto &table = intern_table();
+    std::lock_guard lock{table.mutex};
+    auto const it = table.indices.find(key);
+    if (it == table.indices.cend())
+    {
+        return std::nullopt;
+    }
+    TextureId id{};
+    id._index = it->second;
+    return id;
+}
+
+TextureId TextureId::from_index(uint32_t index)
+{
+    if (index >= count())
+    {
+        throw std::out_of_range{"bad texture ID"};
+    }
+    TextureId id{};
+    id._index = index;
+    return id;
+}
+
+std::string const &TextureId::name() const
+{
+    auto &table = intern_table();
+    std::lock_guard lock{table.mutex};
+    return table.names[_index];
+}
+
+size_t TextureId::count()
+{
+    auto &table = intern_table();
+    std::lock_guard lock{table.mutex};
+    return table.names.size();
+}
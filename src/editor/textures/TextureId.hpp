@@ -0,0 +1,119 @@
+/**
+ * TextureId.hpp - Interned texture names.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_EDITOR_TEXTURES_TEXTUREID_HPP
+#define SE_EDITOR_TEXTURES_TEXTUREID_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace Sickle::Editor::Textures
+{
+    /**
+     * Compact handle for a texture name.
+     *
+     * Names are interned in a global table the first time an ID is made
+     * from them, and never freed. Like the game, names are
+     * case-insensitive: "BRICK" and "brick" get the same ID, whose name()
+     * is whichever spelling was interned first. The default ID is the empty
+     * name.
+     *
+     * IDs are dense, starting from 0, so they can index arrays. Interning
+     * and name() are thread-safe.
+     */
+    class TextureId
+    {
+    public:
+        TextureId() = default;
+
+        /**
+         * Get the ID for a texture name, interning it if it's new.
+         *
+         * @param name The texture name.
+         */
+        explicit TextureId(std::string_view name);
+
+        /**
+         * Look up the ID for a texture name without interning it. Use this
+         * for queries, so names which are only looked up don't fill the
+         * table.
+         *
+         * @param name The texture name.
+         * @return The ID, or nothing if the name was never interned.
+         */
+        static std::optional<TextureId> find(std::string_view name);
+
+        /**
+         * Get the ID with the given index.
+         *
+         * @param index An index from index().
+         * @return The ID.
+         * @throw std::out_of_range if no name has that index.
+         */
+        static TextureId from_index(uint32_t index);
+
+        /**
+         * Get the texture name.
+         *
+         * @return The name. The reference stays valid forever.
+         */
+        std::string const &name() const;
+
+        /**
+         * Get the ID's index into the intern table.
+         *
+         * @return The index, less than count().
+         */
+        uint32_t index() const { return _index; }
+
+        /**
+         * Get how many names have been interned.
+         *
+         * @return The number of names interned so far.
+         */
+        static size_t count();
+
+        bool operator==(TextureId const &other) const
+        {
+            return _index == other._index;
+        }
+
+        bool operator!=(TextureId const &other) const
+        {
+            return _index != other._index;
+        }
+
+    private:
+        uint32_t _index{0};
+    };
+} // namespace Sickle::Editor::Textures
+
+template<>
+struct std::hash<Sickle::Editor::Textures::TextureId>
+{
+    size_t operator()(Sickle::Editor::Textures::TextureId const &id) const
+    {
+        return std::hash<uint32_t>{}(id.index());
+    }
+};
+
+#endif
@@ -17,27 +17,22 @@
  */
 
 #include "TextureInfo.hpp"
+#include "TextureManager.hpp"
 
-#include <functional>
+#include <files/wad/Palette.hpp>
 
 using namespace Sickle::Editor::Textures;
 
-using GetMipmapDataFunc
-    = std::function<std::vector<uint8_t>(WAD::LumpTexture const *)>;
-
-static std::unordered_map<MipmapLevel, GetMipmapDataFunc> const
-    GET_MIPMAP_DATA_FUNCS{
-        {   MipmapLevel::MIPMAP_FULL, std::mem_fn(&WAD::LumpTexture::tex1)},
-        {   MipmapLevel::MIPMAP_HALF, std::mem_fn(&WAD::LumpTexture::tex2)},
-        {MipmapLevel::MIPMAP_QUARTER, std::mem_fn(&WAD::LumpTexture::tex4)},
-        { MipmapLevel::MIPMAP_EIGHTH, std::mem_fn(&WAD::LumpTexture::tex8)},
-};
-
 TextureInfo::TextureInfo(
     std::string source_wad,
-    WAD::LumpTexture const &texlump)
+    std::shared_ptr<WADFile> const &wad,
+    WAD::WADReader::DirectoryEntry const &entry,
+    WAD::WADReader::TextureHeader const &header)
 : _source_wad{source_wad}
-, _texlump{texlump}
+, _wad{wad}
+, _entry{entry}
+, _header{header}
+, _id{header.name}
 {
 }
 
@@ -46,56 +41,67 @@ std::string TextureInfo::get_source_wad() const
     return _source_wad;
 }
 
+std::filesystem::path TextureInfo::get_source_path() const
+{
+    return _wad->path();
+}
+
 std::string TextureInfo::get_name() const
 {
-    return _texlump.name();
+    return _header.name;
+}
+
+TextureId TextureInfo::get_id() const
+{
+    return _id;
 }
 
 unsigned int TextureInfo::get_width(MipmapLevel mipmap) const
 {
-    return _texlump.width() / (1 << static_cast<int>(mipmap));
+    return _header.width / (1 << static_cast<int>(mipmap));
 }
 
 unsigned int TextureInfo::get_height(MipmapLevel mipmap) const
 {
-    return _texlump.height() / (1 << static_cast<int>(mipmap));
+    return _header.height / (1 << static_cast<int>(mipmap));
 }
 
 std::shared_ptr<uint8_t[]> TextureInfo::load_rgba(MipmapLevel mipmap) const
 {
-    auto const &palette = _texlump.palette();
-    auto const tex = std::invoke(GET_MIPMAP_DATA_FUNCS.at(mipmap), &_texlump);
-
     auto const texture_size = get_width(mipmap) * get_height(mipmap);
     std::shared_ptr<uint8_t[]> buffer{new uint8_t[texture_size * 4]};
-
-    for (size_t i = 0; i < texture_size; ++i)
-    {
-        auto const &rgb = palette.at(tex.at(i));
-        buffer[(i * 4) + 0] = rgb.at(0);
-        buffer[(i * 4) + 1] = rgb.at(1);
-        buffer[(i * 4) + 2] = rgb.at(2);
-        buffer[(i * 4) + 3] = 0xff;
-    }
-
+    load_rgba(buffer.get(), mipmap);
     return buffer;
 }
 
 std::shared_ptr<uint8_t[]> TextureInfo::load_rgb(MipmapLevel mipmap) const
 {
-    auto const &palette = _texlump.palette();
-    auto const tex = std::invoke(GET_MIPMAP_DATA_FUNCS.at(mipmap), &_texlump);
-
     auto const texture_size = get_width(mipmap) * get_height(mipmap);
     std::shared_ptr<uint8_t[]> buffer{new uint8_t[texture_size * 3]};
+    load_rgb(buffer.get(), mipmap);
+    return buffer;
+}
 
-    for (size_t i = 0; i < texture_size; ++i)
-    {
-        auto const &rgb = palette.at(tex.at(i));
-        buffer[(i * 3) + 0] = rgb.at(0);
-        buffer[(i * 3) + 1] = rgb.at(1);
-        buffer[(i * 3) + 2] = rgb.at(2);
-    }
+void TextureInfo::load_rgba(uint8_t *buffer, MipmapLevel mipmap) const
+{
+    auto &texman = TextureManager::get_reference();
+    auto const texlump = texman.load_lump(_wad, _entry);
+    WAD::palette_to_rgba(
+        texlump->mipmap(static_cast<size_t>(mipmap)),
+        get_width(mipmap) * get_height(mipmap),
+        texlump->palette(),
+        texlump->palette_size(),
+        buffer);
+}
 
-    return buffer;
+void TextureInfo::load_rgb(uint8_t *buffer, MipmapLevel mipmap) const
+{
+    auto &texman = TextureManager::get_reference();
+    auto const texlump = texman.load_lump(_wad, _entry);
+    WAD::palette_to_rgb(
+        texlump->mipmap(static_cast<size_t>(mipmap)),
+        get_width(mipmap) * get_height(mipmap),
+        texlump->palette(),
+        texlump->palette_size(),
+        buffer);
 }
@@ -19,8 +19,12 @@
 #ifndef SE_EDITOR_TEXTURES_TEXTUREINFO_HPP
 #define SE_EDITOR_TEXTURES_TEXTUREINFO_HPP
 
+#include "TextureId.hpp"
+#include "WADFile.hpp"
+
 #include <files/wad/LumpTexture.hpp>
 
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <typeindex>
@@ -47,6 +51,10 @@ namespace Sickle::Editor::Textures
     /**
      * Holds information about a texture.
      *
+     * Only the texture's name and size are read when the texture is indexed.
+     * Pixel data is loaded on first use, and kept in the TextureManager's
+     * lump cache until it is evicted.
+     *
      * Also has a caching functionality. The cache contains one object for each
      * type. The user can avoid slow reads from disk by using the cache to
      * store already constructed objects.
@@ -61,6 +69,13 @@ namespace Sickle::Editor::Textures
          */
         std::string get_source_wad() const;
 
+        /**
+         * Get the path of the WAD this texture came from.
+         *
+         * @return Path to this texture's source WAD.
+         */
+        std::filesystem::path get_source_path() const;
+
         /**
          * Get this texture's name.
          *
@@ -68,6 +83,13 @@ namespace Sickle::Editor::Textures
          */
         std::string get_name() const;
 
+        /**
+         * Get the interned ID of this texture's name.
+         *
+         * @return The texture's ID.
+         */
+        TextureId get_id() const;
+
         /**
          * Get the width of the texture.
          *
@@ -88,7 +110,8 @@ namespace Sickle::Editor::Textures
 
         /**
          * Load the texture into a buffer. Caller takes ownership of the
-         * buffer. This does blocking I/O.
+         * buffer. This does blocking I/O if the texture isn't in the lump
+         * cache.
          *
          * @param mipmap Mipmap level of the texture to load data from.
          * @return A pointer to the loaded buffer.
@@ -98,7 +121,8 @@ namespace Sickle::Editor::Textures
 
         /**
          * Load the texture into a buffer. Caller takes ownership of the
-         * buffer. This does blocking I/O.
+         * buffer. This does blocking I/O if the texture isn't in the lump
+         * cache.
          *
          * @param mipmap Mipmap level of the texture to load data from.
          * @return A pointer to the loaded buffer.
@@ -106,6 +130,30 @@ namespace Sickle::Editor::Textures
         std::shared_ptr<uint8_t[]> load_rgb(
             MipmapLevel mipmap = MipmapLevel::MIPMAP_FULL) const;
 
+        /**
+         * Load the texture into a caller-provided buffer, so it can be reused
+         * between textures. This does blocking I/O if the texture isn't in
+         * the lump cache.
+         *
+         * @param buffer Buffer at least 4 * width * height bytes long.
+         * @param mipmap Mipmap level of the texture to load data from.
+         */
+        void load_rgba(
+            uint8_t *buffer,
+            MipmapLevel mipmap = MipmapLevel::MIPMAP_FULL) const;
+
+        /**
+         * Load the texture into a caller-provided buffer, so it can be reused
+         * between textures. This does blocking I/O if the texture isn't in
+         * the lump cache.
+         *
+         * @param buffer Buffer at least 3 * width * height bytes long.
+         * @param mipmap Mipmap level of the texture to load data from.
+         */
+        void load_rgb(
+            uint8_t *buffer,
+            MipmapLevel mipmap = MipmapLevel::MIPMAP_FULL) const;
+
         /**
          * Cache an object of type T. If an object is already cached, it will
          * be overwritten.
@@ -152,11 +200,18 @@ namespace Sickle::Editor::Textures
         // TextureInfos can only be created by TextureManagers.
         friend class TextureManager;
 
-        TextureInfo(std::string source_wad, WAD::LumpTexture const &texlump);
+        TextureInfo(
+            std::string source_wad,
+            std::shared_ptr<WADFile> const &wad,
+            WAD::WADReader::DirectoryEntry const &entry,
+            WAD::WADReader::TextureHeader const &header);
 
     private:
         std::string _source_wad;
-        WAD::LumpTexture _texlump;
+        std::shared_ptr<WADFile> _wad;
+        WAD::WADReader::DirectoryEntry _entry;
+        WAD::WADReader::TextureHeader _header;
+        TextureId _id;
 
         std::unordered_map<std::type_index, std::shared_ptr<void>> _cache{};
     };
@@ -19,55 +19,16 @@
 #include "TextureManager.hpp"
 
 #include <files/wad/WADReader.hpp>
+#include <utils/ParallelFor.hpp>
 
-#include <giomm/datainputstream.h>
-#include <giomm/file.h>
-
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <utility>
 
 using namespace Sickle::Editor::Textures;
 
-struct WADInputStreamGIO : WAD::WADInputStream
-{
-    WADInputStreamGIO(std::filesystem::path const &wad_path)
-    {
-        auto const file = Gio::File::create_for_path(wad_path.string());
-        _stream = file->read();
-    }
-
-    virtual ~WADInputStreamGIO() = default;
-
-    virtual void seek(size_t offset)
-    {
-        _stream->seek(offset, Glib::SeekType::SEEK_TYPE_SET);
-    }
-
-    virtual void read_bytes(void *buf, size_t count)
-    {
-        gsize bytes_read = 0;
-        _stream->read_all(buf, count, bytes_read);
-    }
-
-    virtual uint8_t read_uint8()
-    {
-        uint8_t byte = 0;
-        read_bytes(&byte, 1);
-        return byte;
-    }
-
-    virtual uint32_t read_uint32()
-    {
-        uint8_t raw[4];
-        read_bytes(raw, 4);
-        uint32_t num
-            = (raw[0] | (raw[1] << 8) | (raw[2] << 16) | (raw[3] << 24));
-        return num;
-    }
-
-private:
-    Glib::RefPtr<Gio::FileInputStream> _stream{nullptr};
-};
-
 /**
  * Generate a uniquely identifying name for a WAD path given a set of already
  * used names.
@@ -86,6 +47,56 @@ static std::string generate_unique_name(
     return name;
 }
 
+/** A WAD's textures, read by a worker thread. */
+struct IndexedWAD
+{
+    std::shared_ptr<WADFile> wad{nullptr};
+    std::vector<std::pair<
+        WAD::WADReader::DirectoryEntry,
+        WAD::WADReader::TextureHeader>>
+        textures{};
+    std::vector<std::string> errors{};
+};
+
+/**
+ * Open a WAD and read its texture headers. Safe to call from any thread, as
+ * it doesn't touch the TextureManager. Doesn't throw: failures, such as a
+ * truncated WAD or a lump past the end of the file, are recorded in the
+ * result's errors instead. Entries which fail are skipped, and a WAD which
+ * can't be opened has no WADFile.
+ */
+static IndexedWAD index_wad(std::filesystem::path const &wad_path)
+{
+    IndexedWAD result{};
+    try
+    {
+        result.wad = std::make_shared<WADFile>(wad_path);
+        for (auto const &entry : result.wad->directory())
+        {
+            try
+            {
+                auto const header = result.wad->load_texture_header(entry);
+                result.textures.emplace_back(entry, header);
+            }
+            catch (std::exception const &e)
+            {
+                std::string const name{
+                    entry.name,
+                    strnlen(entry.name, sizeof(entry.name))};
+                result.errors.push_back(
+                    wad_path.string() + ": " + name + ": " + e.what());
+            }
+        }
+    }
+    catch (std::exception const &e)
+    {
+        result.wad.reset();
+        result.textures.clear();
+        result.errors.push_back(wad_path.string() + ": " + e.what());
+    }
+    return result;
+}
+
 sigc::signal<void> TextureManager::_sig_wads_changed{};
 
 TextureManager &TextureManager::get_reference()
@@ -98,39 +109,71 @@ TextureManager::TextureManager() {}
 
 void TextureManager::add_wad(std::filesystem::path const &wad_path)
 {
-    // Do nothing if the wad is already in the manager.
-    if (_wad_paths.count(wad_path))
+    add_wads({wad_path});
+}
+
+void TextureManager::add_wads(std::vector<std::filesystem::path> const &paths)
+{
+    // Skip WADs which are already in the manager, or listed twice.
+    std::vector<std::filesystem::path> new_paths{};
+    for (auto const &path : paths)
+    {
+        if (!_wad_paths.count(path)
+            && std::find(new_paths.cbegin(), new_paths.cend(), path)
+                   == new_paths.cend())
+        {
+            new_paths.push_back(path);
+        }
+    }
+    if (new_paths.empty())
     {
         return;
     }
 
-    auto const wad_name = generate_unique_name(wad_path, get_wads());
+    // index_wad() doesn't throw, so nothing can escape a worker.
+    std::vector<IndexedWAD> indexed(new_paths.size());
+    parallel_for(
+        new_paths.size(),
+        [&new_paths, &indexed](size_t i)
+        { indexed[i] = index_wad(new_paths[i]); });
 
-    WADInputStreamGIO inputstream{wad_path};
-    WAD::WADReader reader{inputstream};
-    reader.load();
-
-    std::vector<std::shared_ptr<TextureInfo>> wad_textures{};
-    for (auto const &entry : reader.get_directory())
+    // Commit the results on this thread, in the order given.
+    for (size_t i = 0; i < new_paths.size(); ++i)
     {
-        WAD::LumpTexture texlump{};
-        try
+        auto const &result = indexed.at(i);
+        for (auto const &error : result.errors)
         {
-            texlump = reader.load_lump_texture(entry);
+            std::cerr << "Texture Load Error: " << error << std::endl;
         }
-        catch (WAD::LumpTexture::BadTypeException const &e)
+        if (!result.wad)
         {
-            std::cerr << "Texture Load Error: " << e.what() << std::endl;
             continue;
         }
-        std::shared_ptr<TextureInfo> texture_info{
-            new TextureInfo{wad_name, texlump}
-        };
-        wad_textures.push_back(texture_info);
-        _textures.insert(texture_info);
-        _by_name.insert({texture_info->get_name(), texture_info});
-    }
-    _by_wad.insert({wad_name, wad_textures});
+
+        auto const wad_name = generate_unique_name(new_paths.at(i), get_wads());
+        std::vector<std::shared_ptr<TextureInfo>> wad_textures{};
+        wad_textures.reserve(result.textures.size());
+        for (auto const &[entry, header] : result.textures)
+        {
+            std::shared_ptr<TextureInfo> texture_info{
+                new TextureInfo{wad_name, result.wad, entry, header}
+            };
+            wad_textures.push_back(texture_info);
+            _textures.insert(texture_info);
+            auto const index = texture_info->get_id().index();
+            if (index >= _by_id.size())
+            {
+                _by_id.resize(TextureId::count());
+            }
+            if (!_by_id.at(index))
+            {
+                _by_id.at(index) = texture_info;
+            }
+        }
+        _by_wad.insert({wad_name, wad_textures});
+        _wad_paths.insert({new_paths.at(i), wad_name});
+        _wad_files.insert({wad_name, result.wad});
+    }
     signal_wads_changed().emit();
 }
 
@@ -143,9 +186,27 @@ void TextureManager::remove_wad(std::string const &wad_name)
     for (auto const &texture : _by_wad.at(wad_name))
     {
         _textures.erase(texture);
-        _by_name.erase(texture->get_name());
+        auto &slot = _by_id.at(texture->get_id().index());
+        if (slot == texture)
+        {
+            slot.reset();
+        }
     }
     _by_wad.erase(wad_name);
+
+    _drop_lumps(_wad_files.at(wad_name).get());
+    _wad_files.erase(wad_name);
+    for (auto it = _wad_paths.begin(); it != _wad_paths.end();)
+    {
+        if (it->second == wad_name)
+        {
+            it = _wad_paths.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
     signal_wads_changed().emit();
 }
 
@@ -161,7 +222,15 @@ void TextureManager::clear_wads()
 {
     _textures.clear();
     _by_wad.clear();
-    _by_name.clear();
+    _by_id.clear();
+    _wad_paths.clear();
+    _wad_files.clear();
+    {
+        std::lock_guard lock{_lump_mutex};
+        _lumps.clear();
+        _lru.clear();
+        _memory_usage = 0;
+    }
     signal_wads_changed().emit();
 }
 
@@ -188,5 +257,111 @@ std::unordered_set<std::filesystem::path> TextureManager::get_wad_paths() const
 std::shared_ptr<TextureInfo> TextureManager::get_texture(
     std::string const &name) const
 {
-    return _by_name.at(name);
+    // Don't intern names which are only being looked up.
+    auto const id = TextureId::find(name);
+    if (!id)
+    {
+        throw std::out_of_range{"no texture " + name};
+    }
+    return get_texture(*id);
+}
+
+std::shared_ptr<TextureInfo> TextureManager::get_texture(TextureId id) const
+{
+    if (id.index() >= _by_id.size() || !_by_id[id.index()])
+    {
+        throw std::out_of_range{"no texture " + id.name()};
+    }
+    return _by_id[id.index()];
+}
+
+void TextureManager::set_memory_budget(size_t bytes)
+{
+    std::lock_guard lock{_lump_mutex};
+    _memory_budget = bytes;
+    _trim_lumps();
+}
+
+size_t TextureManager::get_memory_budget() const
+{
+    std::lock_guard lock{_lump_mutex};
+    return _memory_budget;
+}
+
+size_t TextureManager::get_memory_usage() const
+{
+    std::lock_guard lock{_lump_mutex};
+    return _memory_usage;
+}
+
+std::shared_ptr<WAD::LumpTextureView const> TextureManager::load_lump(
+    std::shared_ptr<WADFile> const &wad,
+    WAD::WADReader::DirectoryEntry const &entry)
+{
+    LumpKey const key{wad.get(), entry.lump_offset};
+    {
+        std::lock_guard lock{_lump_mutex};
+        auto const it = _lumps.find(key);
+        if (it != _lumps.end())
+        {
+            _lru.splice(_lru.begin(), _lru, it->second.lru_position);
+            return it->second.lump;
+        }
+    }
+
+    // Load without holding the lock, so cached lumps can still be served by
+    // other threads in the meantime.
+    auto const lump = std::make_shared<WAD::LumpTextureView const>(
+        wad->load_lump_texture(entry));
+
+    std::lock_guard lock{_lump_mutex};
+    auto const [it, inserted] = _lumps.try_emplace(key);
+    if (!inserted)
+    {
+        // Another thread loaded it first.
+        _lru.splice(_lru.begin(), _lru, it->second.lru_position);
+        return it->second.lump;
+    }
+    _lru.push_front(key);
+    it->second = CachedLump{wad, lump, entry, _lru.begin()};
+    _memory_usage += entry.dsize;
+    _trim_lumps();
+    return lump;
+}
+
+size_t TextureManager::LumpKeyHash::operator()(LumpKey const &key) const
+{
+    auto const a = std::hash<WADFile const *>{}(key.first);
+    auto const b = std::hash<uint32_t>{}(key.second);
+    return a ^ (b + 0x9e3779b9 + (a << 6) + (a >> 2));
+}
+
+void TextureManager::_trim_lumps()
+{
+    while (_memory_usage > _memory_budget && _lru.size() > 1)
+    {
+        auto const it = _lumps.find(_lru.back());
+        _memory_usage -= it->second.entry.dsize;
+        it->second.wad->release(it->second.entry);
+        _lumps.erase(it);
+        _lru.pop_back();
+    }
+}
+
+void TextureManager::_drop_lumps(WADFile const *wad)
+{
+    std::lock_guard lock{_lump_mutex};
+    for (auto it = _lumps.begin(); it != _lumps.end();)
+    {
+        if (it->first.first == wad)
+        {
+            _memory_usage -= it->second.entry.dsize;
+            _lru.erase(it->second.lru_position);
+            it = _lumps.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
 }
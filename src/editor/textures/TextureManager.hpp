@@ -23,15 +23,25 @@
 
 #include <sigc++/signal.h>
 
+#include <cstddef>
 #include <filesystem>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace Sickle::Editor::Textures
 {
     /**
      * Singleton managing texture access.
+     *
+     * Adding a WAD only indexes its textures. Texture lumps are loaded on
+     * first use and kept in a least-recently-used cache, which is trimmed to
+     * stay within a memory budget. Lumps point into the memory-mapped WAD,
+     * so the budget limits how much of the WADs the cache keeps in use.
      */
     class TextureManager
     {
@@ -48,8 +58,15 @@ namespace Sickle::Editor::Textures
          */
         static TextureManager &get_reference();
 
+        /** Default lump cache budget, in bytes. */
+        static constexpr size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
+
         /**
-         * Add a WAD to the manager.
+         * Add a WAD to the manager. Only the WAD's directory and texture
+         * headers are read. Doesn't throw if the WAD can't be read: if it
+         * can't be opened, or its directory is corrupt, it isn't added.
+         * Textures whose headers can't be read are skipped. Either way, the
+         * error is logged to stderr.
          *
          * @param wad_path File path to the wad to be added.
          *
@@ -57,6 +74,16 @@ namespace Sickle::Editor::Textures
          */
         void add_wad(std::filesystem::path const &wad_path);
 
+        /**
+         * Add several WADs to the manager. The WADs are indexed in parallel,
+         * then added on the calling thread, and signal_wads_changed() is
+         * emitted once. WADs which can't be opened are skipped, with an
+         * error logged.
+         *
+         * @param paths File paths to the wads to be added.
+         */
+        void add_wads(std::vector<std::filesystem::path> const &paths);
+
         /**
          * Remove a WAD and all its textures from the manager. Fails silently
          * if the path is not in the manager.
@@ -101,6 +128,15 @@ namespace Sickle::Editor::Textures
          */
         std::shared_ptr<TextureInfo> get_texture(std::string const &name) const;
 
+        /**
+         * Get a texture by ID. This is an array lookup.
+         *
+         * @param id ID of the texture to get.
+         * @return Texture info for the texture.
+         * @throw std::out_of_range if the texture does not exist.
+         */
+        std::shared_ptr<TextureInfo> get_texture(TextureId id) const;
+
         /**
          * Get all the textures.
          *
@@ -108,7 +144,61 @@ namespace Sickle::Editor::Textures
          */
         auto get_textures() const { return _textures; }
 
+        /**
+         * Set how much memory cached texture lumps may use. Lumps are
+         * evicted, least recently used first, until usage is within budget.
+         * The most recently used lump is always kept.
+         *
+         * @param bytes The new budget, in bytes.
+         */
+        void set_memory_budget(size_t bytes);
+
+        /**
+         * Get the lump cache's memory budget.
+         *
+         * @return The budget, in bytes.
+         */
+        size_t get_memory_budget() const;
+
+        /**
+         * Get how much memory the cached lumps are using.
+         *
+         * @return Memory used by cached lumps, in bytes.
+         */
+        size_t get_memory_usage() const;
+
+    protected:
+        friend class TextureInfo;
+
+        /**
+         * Get a texture lump, loading it if it isn't cached.
+         *
+         * @param wad The WAD the lump is in.
+         * @param entry Directory entry for the lump.
+         * @return The texture lump.
+         */
+        std::shared_ptr<WAD::LumpTextureView const> load_lump(
+            std::shared_ptr<WADFile> const &wad,
+            WAD::WADReader::DirectoryEntry const &entry);
+
     private:
+        using LumpKey = std::pair<WADFile const *, uint32_t>;
+
+        struct LumpKeyHash
+        {
+            size_t operator()(LumpKey const &key) const;
+        };
+
+        struct CachedLump
+        {
+            // Keeps the WAD alive, so its address can't be reused by another
+            // WAD while the key is in the cache.
+            std::shared_ptr<WADFile> wad;
+            std::shared_ptr<WAD::LumpTextureView const> lump;
+            WAD::WADReader::DirectoryEntry entry;
+            std::list<LumpKey>::iterator lru_position;
+        };
+
         static sigc::signal<void> _sig_wads_changed;
 
         std::unordered_set<std::shared_ptr<TextureInfo>> _textures{};
@@ -118,12 +208,24 @@ namespace Sickle::Editor::Textures
             std::string,
             std::vector<std::shared_ptr<TextureInfo>>>
             _by_wad{};
-        std::unordered_map<std::string, std::shared_ptr<TextureInfo>>
-            _by_name{};
+        // Indexed by TextureId. Names are case-insensitive, so if several
+        // WADs have a texture, the first one added wins.
+        std::vector<std::shared_ptr<TextureInfo>> _by_id{};
+        std::unordered_map<std::string, std::shared_ptr<WADFile>> _wad_files{};
+
+        mutable std::mutex _lump_mutex{};
+        std::unordered_map<LumpKey, CachedLump, LumpKeyHash> _lumps{};
+        // Front is most recently used.
+        std::list<LumpKey> _lru{};
+        size_t _memory_usage{0};
+        size_t _memory_budget{DEFAULT_MEMORY_BUDGET};
 
         TextureManager();
         TextureManager(TextureManager const &) = delete;
         TextureManager &operator=(TextureManager const &) = delete;
+
+        void _trim_lumps();
+        void _drop_lumps(WADFile const *wad);
     };
 } // namespace Sickle::Editor::Textures
 
@@ -0,0 +1,134 @@
+/**
+ * TextureSearchIndex.cpp - Texture name search index.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TextureSearchIndex.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+using namespace Sickle::Editor::Textures;
+
+static std::string to_lower(std::string_view s)
+{
+    std::string out{s};
+    std::transform(
+        out.begin(),
+        out.end(),
+        out.begin(),
+        [](unsigned char c) { return std::tolower(c); });
+    return out;
+}
+
+/** Pack the three characters at S[I] into a key. */
+static uint32_t trigram_at(std::string const &s, size_t i)
+{
+    return (uint32_t{static_cast<unsigned char>(s[i])} << 16)
+         | (uint32_t{static_cast<unsigned char>(s[i + 1])} << 8)
+         | uint32_t{static_cast<unsigned char>(s[i + 2])};
+}
+
+void TextureSearchIndex::rebuild(std::unordered_set<Texture> const &textures)
+{
+    _entries.clear();
+    _wads.clear();
+    _trigrams.clear();
+
+    _entries.reserve(textures.size());
+    for (auto const &texture : textures)
+    {
+        auto const wad = _wads.try_emplace(
+            texture->get_source_wad(),
+            static_cast<uint32_t>(_wads.size()));
+        _entries.push_back(
+            {texture, to_lower(texture->get_name()), wad.first->second});
+    }
+
+    for (uint32_t i = 0; i < _entries.size(); ++i)
+    {
+        auto const &name = _entries[i].name;
+        for (size_t j = 0; j + 3 <= name.size(); ++j)
+        {
+            auto &postings = _trigrams[trigram_at(name, j)];
+            // Names can repeat a trigram.
+            if (postings.empty() || postings.back() != i)
+            {
+                postings.push_back(i);
+            }
+        }
+    }
+}
+
+std::unordered_set<TextureInfo const *> TextureSearchIndex::search(
+    std::string_view query,
+    std::string const &wad) const
+{
+    std::unordered_set<TextureInfo const *> matches{};
+
+    auto wad_id = std::numeric_limits<uint32_t>::max();
+    if (!wad.empty())
+    {
+        auto const it = _wads.find(wad);
+        if (it == _wads.end())
+        {
+            return matches;
+        }
+        wad_id = it->second;
+    }
+
+    auto const needle = to_lower(query);
+    auto const check = [this, &matches, &needle, &wad, wad_id](uint32_t i)
+    {
+        auto const &entry = _entries[i];
+        if ((wad.empty() || entry.wad == wad_id)
+            && entry.name.find(needle) != std::string::npos)
+        {
+            matches.insert(entry.texture.get());
+        }
+    };
+
+    if (needle.size() < 3)
+    {
+        for (uint32_t i = 0; i < _entries.size(); ++i)
+        {
+            check(i);
+        }
+        return matches;
+    }
+
+    // Every match contains all of the needle's trigrams, so only the
+    // textures containing the rarest one need checking.
+    std::vector<uint32_t> const *candidates = nullptr;
+    for (size_t j = 0; j + 3 <= needle.size(); ++j)
+    {
+        auto const it = _trigrams.find(trigram_at(needle, j));
+        if (it == _trigrams.end())
+        {
+            return matches;
+        }
+        if (!candidates || it->second.size() < candidates->size())
+        {
+            candidates = &it->second;
+        }
+    }
+    for (auto const i : *candidates)
+    {
+        check(i);
+    }
+    return matches;
+}
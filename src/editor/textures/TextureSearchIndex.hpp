@@ -0,0 +1,84 @@
+/**
+ * TextureSearchIndex.hpp - Texture name search index.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_EDITOR_TEXTURES_TEXTURESEARCHINDEX_HPP
+#define SE_EDITOR_TEXTURES_TEXTURESEARCHINDEX_HPP
+
+#include "TextureInfo.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Sickle::Editor::Textures
+{
+    /**
+     * Index for finding textures whose name contains a substring.
+     *
+     * Every three-character sequence (trigram) of each lowercased name maps
+     * to the textures containing it. A search only checks the textures
+     * sharing the query's rarest trigram, rather than every texture.
+     * Queries shorter than three characters fall back to checking every
+     * name. Like texture names themselves, searches ignore case.
+     */
+    class TextureSearchIndex
+    {
+    public:
+        using Texture = std::shared_ptr<TextureInfo>;
+
+        /**
+         * Replace the indexed textures.
+         *
+         * @param textures The textures to index.
+         */
+        void rebuild(std::unordered_set<Texture> const &textures);
+
+        /**
+         * Find the textures whose name contains QUERY.
+         *
+         * @param query Substring to search for. Empty matches everything.
+         * @param wad Only match textures from this WAD. Empty matches any
+         *            WAD.
+         * @return The matching textures. The pointers are owned by the
+         *         index, so stay valid until the next rebuild().
+         */
+        std::unordered_set<TextureInfo const *> search(
+            std::string_view query,
+            std::string const &wad = "") const;
+
+    private:
+        struct Entry
+        {
+            Texture texture;
+            // Lowercased.
+            std::string name;
+            uint32_t wad;
+        };
+
+        std::vector<Entry> _entries{};
+        std::unordered_map<std::string, uint32_t> _wads{};
+        // Trigram to indices into _entries, in ascending order.
+        std::unordered_map<uint32_t, std::vector<uint32_t>> _trigrams{};
+    };
+} // namespace Sickle::Editor::Textures
+
+#endif
@@ -0,0 +1,534 @@
+/**
+ * ThumbnailCache.cpp - Persistent texture thumbnail cache.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ThumbnailCache.hpp"
+
+#include <utils/MappedFile.hpp>
+
+#include <glibmm/miscutils.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+using namespace Sickle::Editor::Textures;
+
+/*
+ * Pack file layout. All values are stored in native byte order, since the
+ * pack never leaves the machine that wrote it.
+ *
+ * Header:
+ *   char[4]  "SETC"
+ *   u32      FORMAT_VERSION
+ *   u32      MAX_SIZE the thumbnails were made with
+ * Records follow the header, up to the end of the file. New thumbnails are
+ * appended as new records. A record for a WAD which is already in the pack
+ * adds to its thumbnails if the modification time and size match, and
+ * replaces them otherwise.
+ * Record:
+ *   u64      size of the rest of the record
+ *   u32      path length, followed by the path
+ *   i64      modification time
+ *   u64      size
+ *   u32      thumbnail count, followed by the thumbnails
+ * Thumbnail:
+ *   char[16] lump name
+ *   u32      width
+ *   u32      height
+ *   u64      offset of the RGB pixels from the start of the record
+ * The pixels follow the last thumbnail.
+ */
+static constexpr char MAGIC[4] = {'S', 'E', 'T', 'C'};
+/** Bump whenever the layout or the thumbnails' contents change. */
+static constexpr uint32_t FORMAT_VERSION = 2;
+static constexpr size_t HEADER_SIZE = sizeof(MAGIC) + 2 * sizeof(uint32_t);
+static constexpr size_t THUMBNAIL_ENTRY_SIZE = 16 + 4 + 4 + 8;
+
+/** Thrown when the pack is truncated or corrupt. */
+struct PackError : std::runtime_error
+{
+    PackError()
+    : std::runtime_error{"invalid thumbnail pack"}
+    {
+    }
+};
+
+/** Bounds-checked reads from the mapped pack. */
+class PackReader
+{
+public:
+    explicit PackReader(std::string_view data)
+    : _data{data}
+    {
+    }
+
+    template<class T>
+    T read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, _take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string read_string()
+    {
+        auto const length = read<uint32_t>();
+        return std::string{_take(length), length};
+    }
+
+    /** Read a count of items, each at least MIN_SIZE bytes long. */
+    uint32_t read_count(size_t min_size)
+    {
+        auto const count = read<uint32_t>();
+        if (count > (_data.size() - _pos) / min_size)
+        {
+            throw PackError{};
+        }
+        return count;
+    }
+
+private:
+    std::string_view _data;
+    size_t _pos{0};
+
+    char const *_take(size_t count)
+    {
+        if (count > _data.size() - _pos)
+        {
+            throw PackError{};
+        }
+        auto const ptr = _data.data() + _pos;
+        _pos += count;
+        return ptr;
+    }
+};
+
+template<class T>
+static void append(std::string &out, T const &value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    out.append(reinterpret_cast<char const *>(&value), sizeof(value));
+}
+
+/**
+ * Shrink a thumbnail by FACTOR in each direction. Each new pixel is the
+ * average of the block it covers.
+ */
+static Thumbnail shrink(Thumbnail const &thumbnail, unsigned int factor)
+{
+    Thumbnail out{};
+    out.width = std::max(thumbnail.width / factor, 1u);
+    out.height = std::max(thumbnail.height / factor, 1u);
+    std::shared_ptr<uint8_t[]> pixels{new uint8_t[out.width * out.height * 3]};
+    auto const src = thumbnail.pixels.get();
+    for (unsigned int y = 0; y < out.height; ++y)
+    {
+        auto const y_end = std::min((y + 1) * factor, thumbnail.height);
+        for (unsigned int x = 0; x < out.width; ++x)
+        {
+            auto const x_end = std::min((x + 1) * factor, thumbnail.width);
+            unsigned int sum[3] = {0, 0, 0};
+            for (auto sy = y * factor; sy < y_end; ++sy)
+            {
+                for (auto sx = x * factor; sx < x_end; ++sx)
+                {
+                    auto const pixel = src + (sy * thumbnail.width + sx) * 3;
+                    sum[0] += pixel[0];
+                    sum[1] += pixel[1];
+                    sum[2] += pixel[2];
+                }
+            }
+            auto const count = (y_end - y * factor) * (x_end - x * factor);
+            auto const dst = pixels.get() + (y * out.width + x) * 3;
+            dst[0] = static_cast<uint8_t>(sum[0] / count);
+            dst[1] = static_cast<uint8_t>(sum[1] / count);
+            dst[2] = static_cast<uint8_t>(sum[2] / count);
+        }
+    }
+    out.pixels = pixels;
+    return out;
+}
+
+bool ThumbnailCache::Stamp::operator==(Stamp const &other) const
+{
+    return mtime == other.mtime && size == other.size;
+}
+
+ThumbnailCache::ThumbnailCache()
+: _pack_path{
+      std::filesystem::path{Glib::get_user_cache_dir()} / "sickle"
+      / "thumbnails.pack"}
+{
+    _load();
+}
+
+ThumbnailCache::~ThumbnailCache() = default;
+
+Thumbnail ThumbnailCache::get(TextureInfo const &texinfo)
+{
+    auto const wad_path = texinfo.get_source_path();
+    auto used_it = _used.find(wad_path.string());
+    if (used_it == _used.end())
+    {
+        used_it = _used.emplace(wad_path.string(), UsedWAD{_stamp(wad_path)})
+                      .first;
+    }
+    auto &used = used_it->second;
+    auto const name = texinfo.get_name();
+
+    auto const packed = _packed.find(wad_path.string());
+    if (packed != _packed.end() && packed->second.stamp == used.stamp)
+    {
+        auto const it = packed->second.thumbnails.find(name);
+        if (it != packed->second.thumbnails.end())
+        {
+            return it->second;
+        }
+    }
+    auto const added = used.added.find(name);
+    if (added != used.added.end())
+    {
+        return added->second;
+    }
+
+    // Not cached. Use the largest mipmap which fits, so there's usually no
+    // need to resample.
+    auto mipmap = MipmapLevel::MIPMAP_FULL;
+    while (mipmap != MipmapLevel::MIPMAP_EIGHTH
+           && std::max(texinfo.get_width(mipmap), texinfo.get_height(mipmap))
+                  > MAX_SIZE)
+    {
+        mipmap = static_cast<MipmapLevel>(mipmap + 1);
+    }
+
+    Thumbnail thumbnail{};
+    thumbnail.width = texinfo.get_width(mipmap);
+    thumbnail.height = texinfo.get_height(mipmap);
+    std::shared_ptr<uint8_t[]> pixels{
+        new uint8_t[thumbnail.width * thumbnail.height * 3]};
+    texinfo.load_rgb(pixels.get(), mipmap);
+    thumbnail.pixels = pixels;
+
+    // Only textures over 8 times MAX_SIZE are still too big.
+    auto const largest = std::max(thumbnail.width, thumbnail.height);
+    if (largest > MAX_SIZE)
+    {
+        thumbnail = shrink(thumbnail, (largest + MAX_SIZE - 1) / MAX_SIZE);
+    }
+
+    used.added.emplace(name, thumbnail);
+    _changed = true;
+    return thumbnail;
+}
+
+void ThumbnailCache::save()
+{
+    if (!_changed)
+    {
+        return;
+    }
+
+    // Appending is only safe onto a pack which is exactly as it was loaded.
+    // Truncating it instead could pull pages out from under another
+    // process which has it mapped.
+    std::error_code ec{};
+    auto const size = std::filesystem::file_size(_pack_path, ec);
+    bool const can_append = _pack_end != 0 && !ec && size == _pack_end;
+    if (can_append && _stale_bytes <= _pack_end - HEADER_SIZE - _stale_bytes)
+    {
+        _append();
+    }
+    else
+    {
+        _rewrite();
+    }
+    _changed = false;
+}
+
+ThumbnailCache::Stamp ThumbnailCache::_stamp(
+    std::filesystem::path const &wad_path)
+{
+    std::error_code ec{};
+    Stamp stamp{};
+    auto const mtime = std::filesystem::last_write_time(wad_path, ec);
+    if (!ec)
+    {
+        stamp.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+    }
+    auto const size = std::filesystem::file_size(wad_path, ec);
+    if (!ec)
+    {
+        stamp.size = static_cast<uint64_t>(size);
+    }
+    return stamp;
+}
+
+uint64_t ThumbnailCache::_write_record(
+    std::ostream &out,
+    std::string const &path,
+    Stamp const &stamp,
+    std::unordered_map<std::string, Thumbnail> const &thumbnails)
+{
+    // The index comes first, so its size is needed to work out where each
+    // thumbnail's pixels will go.
+    uint64_t offset = sizeof(uint64_t) + sizeof(uint32_t) + path.size()
+                    + sizeof(int64_t) + sizeof(uint64_t) + sizeof(uint32_t)
+                    + thumbnails.size() * THUMBNAIL_ENTRY_SIZE;
+    uint64_t record_size = offset;
+    for (auto const &[name, thumbnail] : thumbnails)
+    {
+        record_size += thumbnail.width * thumbnail.height * 3;
+    }
+
+    std::string index{};
+    index.reserve(offset);
+    append(index, record_size - sizeof(uint64_t));
+    append(index, static_cast<uint32_t>(path.size()));
+    index.append(path);
+    append(index, stamp.mtime);
+    append(index, stamp.size);
+    append(index, static_cast<uint32_t>(thumbnails.size()));
+    for (auto const &[name, thumbnail] : thumbnails)
+    {
+        std::array<char, 16> lump_name{};
+        std::copy_n(
+            name.cbegin(),
+            std::min(name.size(), lump_name.size()),
+            lump_name.begin());
+        append(index, lump_name);
+        append(index, static_cast<uint32_t>(thumbnail.width));
+        append(index, static_cast<uint32_t>(thumbnail.height));
+        append(index, offset);
+        offset += thumbnail.width * thumbnail.height * 3;
+    }
+
+    out.write(index.data(), static_cast<std::streamsize>(index.size()));
+    for (auto const &[name, thumbnail] : thumbnails)
+    {
+        out.write(
+            reinterpret_cast<char const *>(thumbnail.pixels.get()),
+            static_cast<std::streamsize>(
+                thumbnail.width * thumbnail.height * 3));
+    }
+    return record_size;
+}
+
+void ThumbnailCache::_load()
+{
+    std::string_view data{};
+    try
+    {
+        _file = std::make_shared<MappedFile const>(
+            _pack_path.string(),
+            MappedFile::Access::RANDOM);
+        data = _file->view();
+        PackReader in{data};
+
+        auto const magic = in.read<std::array<char, 4>>();
+        if (!std::equal(magic.cbegin(), magic.cend(), MAGIC)
+            || in.read<uint32_t>() != FORMAT_VERSION
+            || in.read<uint32_t>() != MAX_SIZE)
+        {
+            return;
+        }
+    }
+    catch (std::exception const &)
+    {
+        // Missing or truncated pack.
+        return;
+    }
+
+    _pack_end = HEADER_SIZE;
+    while (_pack_end < data.size())
+    {
+        auto const record_data = data.substr(_pack_end);
+        PackedWAD record{};
+        std::string path{};
+        try
+        {
+            PackReader in{record_data};
+            auto const record_size = in.read<uint64_t>() + sizeof(uint64_t);
+            if (record_size > record_data.size())
+            {
+                throw PackError{};
+            }
+            in = PackReader{record_data.substr(sizeof(uint64_t), record_size)};
+            path = in.read_string();
+            record.stamp.mtime = in.read<int64_t>();
+            record.stamp.size = in.read<uint64_t>();
+            record.bytes = record_size;
+
+            auto const count = in.read_count(THUMBNAIL_ENTRY_SIZE);
+            for (uint32_t t = 0; t < count; ++t)
+            {
+                auto const name = in.read<std::array<char, 16>>();
+                Thumbnail thumbnail{};
+                thumbnail.width = in.read<uint32_t>();
+                thumbnail.height = in.read<uint32_t>();
+                auto const offset = in.read<uint64_t>();
+                auto const size = uint64_t{thumbnail.width} * thumbnail.height
+                                * 3;
+                if (offset > record_size || size > record_size - offset)
+                {
+                    throw PackError{};
+                }
+                // Shares ownership of the mapping.
+                thumbnail.pixels = std::shared_ptr<uint8_t const[]>{
+                    _file,
+                    reinterpret_cast<uint8_t const *>(
+                        record_data.data() + offset)};
+                record.thumbnails.emplace(
+                    std::string{
+                        name.data(),
+                        strnlen(name.data(), name.size())},
+                    thumbnail);
+            }
+        }
+        catch (std::exception const &)
+        {
+            // A truncated or corrupt record ends the pack. Anything after
+            // it is dropped the next time the pack is saved.
+            break;
+        }
+
+        auto &wad = _packed[path];
+        if (!(wad.stamp == record.stamp))
+        {
+            _stale_bytes += wad.bytes;
+            wad.stamp = record.stamp;
+            wad.thumbnails.clear();
+            wad.bytes = 0;
+        }
+        wad.thumbnails.merge(record.thumbnails);
+        wad.bytes += record.bytes;
+        _pack_end += record.bytes;
+    }
+}
+
+void ThumbnailCache::_append()
+{
+    std::ofstream file{
+        _pack_path,
+        std::ios::in | std::ios::out | std::ios::binary};
+    file.seekp(static_cast<std::streamoff>(_pack_end));
+    for (auto &[path, used] : _used)
+    {
+        if (used.added.empty())
+        {
+            continue;
+        }
+        auto const bytes = _write_record(file, path, used.stamp, used.added);
+        if (!file)
+        {
+            // The partial record is dropped the next time the pack is
+            // loaded.
+            _pack_end = 0;
+            return;
+        }
+
+        auto &wad = _packed[path];
+        if (!(wad.stamp == used.stamp))
+        {
+            _stale_bytes += wad.bytes;
+            wad.stamp = used.stamp;
+            wad.thumbnails.clear();
+            wad.bytes = 0;
+        }
+        wad.thumbnails.merge(used.added);
+        wad.bytes += bytes;
+        _pack_end += bytes;
+        used.added.clear();
+    }
+}
+
+void ThumbnailCache::_rewrite()
+{
+    // Keep every WAD's thumbnails which are still valid, whether or not
+    // they were asked for this time.
+    std::unordered_map<std::string, PackedWAD> packed{};
+    for (auto const &[path, wad] : _packed)
+    {
+        auto const used = _used.find(path);
+        if (used == _used.end() || used->second.stamp == wad.stamp)
+        {
+            packed[path] = wad;
+        }
+    }
+    for (auto const &[path, used] : _used)
+    {
+        auto &wad = packed[path];
+        if (!(wad.stamp == used.stamp))
+        {
+            wad.stamp = used.stamp;
+            wad.thumbnails.clear();
+        }
+        wad.thumbnails.insert(used.added.cbegin(), used.added.cend());
+    }
+
+    // Write to a temporary file and rename it into place, so an interrupted
+    // write can't leave a half-written pack behind.
+    std::error_code ec{};
+    std::filesystem::create_directories(_pack_path.parent_path(), ec);
+    auto temp_path = _pack_path;
+    temp_path += ".tmp";
+    uint64_t pack_end = HEADER_SIZE;
+    {
+        std::ofstream file{temp_path, std::ios::out | std::ios::binary};
+        std::string header{MAGIC, sizeof(MAGIC)};
+        append(header, FORMAT_VERSION);
+        append(header, static_cast<uint32_t>(MAX_SIZE));
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        for (auto &[path, wad] : packed)
+        {
+            if (wad.thumbnails.empty())
+            {
+                wad.bytes = 0;
+                continue;
+            }
+            wad.bytes = _write_record(file, path, wad.stamp, wad.thumbnails);
+            pack_end += wad.bytes;
+        }
+        if (!file)
+        {
+            file.close();
+            std::filesystem::remove(temp_path, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(temp_path, _pack_path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(temp_path, ec);
+        return;
+    }
+
+    // Pixels already loaded from the old pack stay valid, since it stays
+    // mapped until they're released.
+    _packed = std::move(packed);
+    _pack_end = pack_end;
+    _stale_bytes = 0;
+    for (auto &[path, used] : _used)
+    {
+        used.added.clear();
+    }
+}
@@ -0,0 +1,140 @@
+/**
+ * ThumbnailCache.hpp - Persistent texture thumbnail cache.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_EDITOR_TEXTURES_THUMBNAILCACHE_HPP
+#define SE_EDITOR_TEXTURES_THUMBNAILCACHE_HPP
+
+#include "TextureInfo.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+class MappedFile;
+
+namespace Sickle::Editor::Textures
+{
+    /**
+     * An RGB texture thumbnail.
+     */
+    struct Thumbnail
+    {
+        /// Tightly packed RGB pixels, width * height * 3 bytes.
+        std::shared_ptr<uint8_t const[]> pixels{nullptr};
+        unsigned int width{0};
+        unsigned int height{0};
+    };
+
+    /**
+     * Cache of texture thumbnails, kept between runs.
+     *
+     * Thumbnails are the largest mipmap no bigger than MAX_SIZE, expanded to
+     * RGB. Textures whose smallest mipmap is still too big are shrunk to
+     * fit. They're all stored in one pack file in the user's cache
+     * directory, which is memory-mapped, so cached thumbnails don't need
+     * copying. Thumbnails are keyed by WAD path and lump name, and a WAD's
+     * thumbnails are only used if its modification time and size still
+     * match.
+     *
+     * New thumbnails are appended to the pack. It's only rewritten once
+     * most of it is taken up by thumbnails of WADs which have since changed.
+     *
+     * Not thread-safe. Thumbnails stay valid after the cache is destroyed.
+     */
+    class ThumbnailCache
+    {
+    public:
+        /** Largest width or height of a thumbnail. */
+        static constexpr unsigned int MAX_SIZE = 64;
+
+        /**
+         * Open the pack file. A missing or corrupt pack is treated as
+         * empty.
+         */
+        ThumbnailCache();
+        ~ThumbnailCache();
+
+        ThumbnailCache(ThumbnailCache const &) = delete;
+        ThumbnailCache &operator=(ThumbnailCache const &) = delete;
+
+        /**
+         * Get a texture's thumbnail, from the pack if possible. Otherwise
+         * it's made from the texture, which does blocking I/O.
+         *
+         * @param texinfo The texture.
+         * @return The texture's thumbnail.
+         */
+        Thumbnail get(TextureInfo const &texinfo);
+
+        /**
+         * Add the thumbnails made by get() to the pack. Since the cache is
+         * only an optimization, failures are ignored.
+         */
+        void save();
+
+    private:
+        /** A WAD's modification time and size. */
+        struct Stamp
+        {
+            int64_t mtime{0};
+            uint64_t size{0};
+
+            bool operator==(Stamp const &other) const;
+        };
+
+        struct PackedWAD
+        {
+            Stamp stamp{};
+            std::unordered_map<std::string, Thumbnail> thumbnails{};
+            /** Size of the WAD's records in the pack. */
+            uint64_t bytes{0};
+        };
+
+        struct UsedWAD
+        {
+            Stamp stamp{};
+            /** Thumbnails made since the pack was loaded. */
+            std::unordered_map<std::string, Thumbnail> added{};
+        };
+
+        std::filesystem::path _pack_path{};
+        std::shared_ptr<MappedFile const> _file{nullptr};
+        std::unordered_map<std::string, PackedWAD> _packed{};
+        std::unordered_map<std::string, UsedWAD> _used{};
+        /** End of the last complete record, or 0 if the pack is unusable. */
+        uint64_t _pack_end{0};
+        /** Bytes of records for WADs which have since changed. */
+        uint64_t _stale_bytes{0};
+        bool _changed{false};
+
+        static Stamp _stamp(std::filesystem::path const &wad_path);
+        static uint64_t _write_record(
+            std::ostream &out,
+            std::string const &path,
+            Stamp const &stamp,
+            std::unordered_map<std::string, Thumbnail> const &thumbnails);
+        void _load();
+        void _append();
+        void _rewrite();
+    };
+} // namespace Sickle::Editor::Textures
+
+#endif
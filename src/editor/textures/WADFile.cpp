@@ -0,0 +1,63 @@
+/**
+ * WADFile.cpp - An open texture WAD.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "WADFile.hpp"
+
+#include <files/wad/WADInputStreamMapped.hpp>
+
+using namespace Sickle::Editor::Textures;
+
+WADFile::WADFile(std::filesystem::path const &path)
+: _path{path}
+, _stream{std::make_unique<WAD::WADInputStreamMapped>(path.string())}
+, _reader{*_stream}
+{
+    _reader.load();
+}
+
+WADFile::~WADFile() = default;
+
+std::filesystem::path const &WADFile::path() const
+{
+    return _path;
+}
+
+std::vector<WAD::WADReader::DirectoryEntry> const &WADFile::directory() const
+{
+    return _reader.get_directory();
+}
+
+WAD::WADReader::TextureHeader WADFile::load_texture_header(
+    WAD::WADReader::DirectoryEntry const &entry)
+{
+    std::lock_guard lock{_mutex};
+    return _reader.load_texture_header(entry);
+}
+
+WAD::LumpTextureView WADFile::load_lump_texture(
+    WAD::WADReader::DirectoryEntry const &entry)
+{
+    std::lock_guard lock{_mutex};
+    return _reader.load_lump_texture_view(entry);
+}
+
+void WADFile::release(WAD::WADReader::DirectoryEntry const &entry)
+{
+    std::lock_guard lock{_mutex};
+    _stream->release(entry.lump_offset, entry.dsize);
+}
@@ -0,0 +1,105 @@
+/**
+ * WADFile.hpp - An open texture WAD.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_EDITOR_TEXTURES_WADFILE_HPP
+#define SE_EDITOR_TEXTURES_WADFILE_HPP
+
+#include <files/wad/WADReader.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Sickle::Editor::Textures
+{
+    /**
+     * An open WAD file. Keeps the file mapped so that lumps can be read on
+     * demand after the directory has been indexed.
+     *
+     * All methods are thread-safe.
+     */
+    class WADFile
+    {
+    public:
+        /**
+         * Open a WAD and read its directory.
+         *
+         * @param path Path to the WAD.
+         * @throw std::runtime_error if the file can't be opened.
+         */
+        explicit WADFile(std::filesystem::path const &path);
+        ~WADFile();
+
+        WADFile(WADFile const &) = delete;
+        WADFile &operator=(WADFile const &) = delete;
+
+        /**
+         * Get the path the WAD was opened from.
+         *
+         * @return Path to the WAD.
+         */
+        std::filesystem::path const &path() const;
+
+        /**
+         * Get the WAD's directory.
+         *
+         * @return All the directory entries in the WAD.
+         */
+        std::vector<WAD::WADReader::DirectoryEntry> const &directory() const;
+
+        /**
+         * Read the header of a texture lump.
+         *
+         * @param entry Directory entry for the lump.
+         * @return The texture's name and size.
+         * @throw WAD::LumpTexture::BadTypeException if lump is not a texture
+         *        lump.
+         */
+        WAD::WADReader::TextureHeader load_texture_header(
+            WAD::WADReader::DirectoryEntry const &entry);
+
+        /**
+         * Get a texture lump. Its data isn't copied, it points into the
+         * mapped file.
+         *
+         * @param entry Directory entry for the lump.
+         * @return A view of the texture lump.
+         * @throw WAD::LumpTexture::BadTypeException if lump is not a texture
+         *        lump.
+         */
+        WAD::LumpTextureView load_lump_texture(
+            WAD::WADReader::DirectoryEntry const &entry);
+
+        /**
+         * Let the memory used by a lump's data be reclaimed. Views of the
+         * lump stay valid.
+         *
+         * @param entry Directory entry for the lump.
+         */
+        void release(WAD::WADReader::DirectoryEntry const &entry);
+
+    private:
+        std::filesystem::path _path;
+        std::unique_ptr<WAD::WADInputStream> _stream;
+        WAD::WADReader _reader;
+        std::mutex _mutex{};
+    };
+} // namespace Sickle::Editor::Textures
+
+#endif
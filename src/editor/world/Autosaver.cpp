@@ -0,0 +1,196 @@
+/**
+ * Autosaver.cpp - Background world saving.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Autosaver.hpp"
+
+#include <files/map/mapsaver.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace Sickle::Editor;
+
+/** Flush a file's contents all the way to disk. */
+static bool sync_file(std::FILE *file)
+{
+    if (std::fflush(file) != 0)
+    {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+/**
+ * Get a temporary name for a save to FINAL_PATH. Every save gets its own, so
+ * two saves to the same path can't write over each other's temporary file.
+ */
+static std::filesystem::path make_temp_path(
+    std::filesystem::path const &final_path)
+{
+    static std::atomic_uint64_t next_id{0};
+    auto temp_path = final_path;
+    temp_path += "." + std::to_string(next_id++) + ".tmp";
+    return temp_path;
+}
+
+/**
+ * Write the entities to PATH. Brushes without cached text are formatted
+ * here. The file is written under a temporary name and renamed into place
+ * once it is on disk, so a crash partway through leaves the last complete
+ * autosave intact.
+ */
+template<class Snapshot>
+static void write_snapshot(Snapshot const &snapshot, std::string const &path)
+{
+    std::filesystem::path const final_path{path};
+    auto const temp_path = make_temp_path(final_path);
+
+    bool ok = false;
+    {
+        std::ofstream out{temp_path, std::ios::out | std::ios::binary};
+        if (!out)
+        {
+            throw std::system_error{errno, std::generic_category(), path};
+        }
+        {
+            MAP::MAPWriter writer{out};
+            for (auto const &entity : snapshot)
+            {
+                entity.write(writer);
+                writer.write_raw("\n");
+            }
+        }
+        out.close();
+        ok = !out.fail();
+    }
+    // Streams can't be synced, so reopen the file to flush it to disk.
+    if (ok)
+    {
+        auto const file = std::fopen(temp_path.string().c_str(), "r+b");
+        ok = file && sync_file(file);
+        ok = file && (std::fclose(file) == 0) && ok;
+    }
+    if (!ok)
+    {
+        std::error_code ec{};
+        std::filesystem::remove(temp_path, ec);
+        throw std::runtime_error{"failed to write " + temp_path.string()};
+    }
+    std::filesystem::rename(temp_path, final_path);
+}
+
+Autosaver::Autosaver()
+: _thread{&Autosaver::_run, this}
+{
+}
+
+Autosaver::~Autosaver()
+{
+    {
+        std::lock_guard const lock{_mutex};
+        _stopping = true;
+    }
+    _cv.notify_one();
+    _thread.join();
+}
+
+std::chrono::steady_clock::duration Autosaver::save(
+    WorldRef const &world,
+    std::string const &path)
+{
+    auto const start = std::chrono::steady_clock::now();
+
+    auto const &entities = world->entities();
+    std::vector<uint64_t> revisions{};
+    revisions.reserve(entities.size());
+    for (auto const &entity : entities)
+    {
+        revisions.push_back(entity->revision());
+    }
+
+    {
+        std::lock_guard const lock{_mutex};
+        if (path == _last_path && revisions == _last_revisions)
+        {
+            return std::chrono::steady_clock::now() - start;
+        }
+        _last_path = path;
+        _last_revisions = std::move(revisions);
+    }
+
+    Job job{{}, path};
+    job.snapshot.reserve(entities.size());
+    for (auto const &entity : entities)
+    {
+        job.snapshot.push_back(entity->map_snapshot());
+    }
+    {
+        std::lock_guard const lock{_mutex};
+        _pending = std::move(job);
+    }
+    _cv.notify_one();
+
+    return std::chrono::steady_clock::now() - start;
+}
+
+void Autosaver::_run()
+{
+    std::unique_lock lock{_mutex};
+    for (;;)
+    {
+        _cv.wait(lock, [this] { return _stopping || _pending.has_value(); });
+        // Finish the last requested save before stopping, so closing the
+        // editor right after an autosave doesn't lose it.
+        if (!_pending)
+        {
+            return;
+        }
+        auto const job = std::move(*_pending);
+        _pending.reset();
+
+        lock.unlock();
+        try
+        {
+            write_snapshot(job.snapshot, job.path);
+        }
+        catch (std::exception const &e)
+        {
+            std::cerr << "Autosave failed: " << e.what() << std::endl;
+            // Make sure the next save isn't skipped as unchanged.
+            lock.lock();
+            _last_revisions.clear();
+            continue;
+        }
+        lock.lock();
+    }
+}
@@ -0,0 +1,90 @@
+/**
+ * Autosaver.hpp - Background world saving.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_EDITOR_WORLD_AUTOSAVER_HPP
+#define SE_EDITOR_WORLD_AUTOSAVER_HPP
+
+#include "World.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Sickle::Editor
+{
+    /**
+     * Saves worlds as .map files on a worker thread.
+     *
+     * The only work done on the calling thread is taking a snapshot of the
+     * world, which copies no brushes. Each brush's cached .map text is
+     * shared with the brush, and brushes without cached text share their
+     * immutable MAP data instead, to be formatted on the worker thread. The
+     * snapshot is then written to disk and flushed with fsync() on the
+     * worker thread.
+     */
+    class Autosaver
+    {
+    public:
+        Autosaver();
+        /** Waits for a save in progress to finish. */
+        ~Autosaver();
+
+        Autosaver(Autosaver const &) = delete;
+        Autosaver &operator=(Autosaver const &) = delete;
+
+        /**
+         * Save WORLD to PATH in the background. If the previous save hasn't
+         * started yet, it is replaced by this one. Nothing is saved if no
+         * entity has changed since the last save to PATH.
+         *
+         * @param world The world to save.
+         * @param path Where to write the .map file.
+         * @return Time spent on the calling thread.
+         */
+        std::chrono::steady_clock::duration save(
+            WorldRef const &world,
+            std::string const &path);
+
+    private:
+        using Snapshot = std::vector<Entity::MapSnapshot>;
+
+        struct Job
+        {
+            Snapshot snapshot;
+            std::string path;
+        };
+
+        std::mutex _mutex{};
+        std::condition_variable _cv{};
+        std::optional<Job> _pending{};
+        /** Path and entity revisions of the last save, to skip repeats. */
+        std::string _last_path{};
+        std::vector<uint64_t> _last_revisions{};
+        bool _stopping{false};
+        std::thread _thread;
+
+        void _run();
+    };
+} // namespace Sickle::Editor
+
+#endif
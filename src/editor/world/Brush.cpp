@@ -19,11 +19,25 @@
 #include "Brush.hpp"
 
 #include <config/appid.hpp>
+#include <files/map/mapsaver.hpp>
 
+#include <random>
 #include <sstream>
+#include <stdexcept>
 
 using namespace Sickle::Editor;
 
+/** Pick a color for a new brush, the same way Worldcraft does. */
+static RMF::Color random_color()
+{
+    static std::minstd_rand rng{std::random_device{}()};
+    std::uniform_int_distribution<int> channel{100, 255};
+    return {
+        0,
+        static_cast<uint8_t>(channel(rng)),
+        static_cast<uint8_t>(channel(rng))};
+}
+
 BrushRef Brush::create()
 {
     return Glib::RefPtr{new Brush()};
@@ -39,28 +53,33 @@ BrushRef Brush::create(std::vector<glm::vec3> const &vertices)
     for (auto const &facet : facets)
     {
         auto const face = Face::create(facet, vertices2);
-        result->_faces.push_back(face);
-        result->signal_child_added().emit(face);
+        result->_add_face(face);
     }
     return result;
 }
 
-BrushRef Brush::create(MAP::Brush const &brush)
+Brush::Geometry Brush::compute_geometry(MAP::Brush const &brush)
 {
     std::vector<HalfPlane> halfplanes{};
     for (auto const &plane : brush.planes)
     {
         halfplanes.emplace_back(plane.a, plane.b, plane.c);
     }
-    auto const vertices = vertex_enumeration(halfplanes);
-    assert(vertices.size() != 0);
+    return face_enumeration(halfplanes);
+}
+
+BrushRef Brush::create(MAP::Brush const &brush)
+{
+    return create(brush, compute_geometry(brush));
+}
 
+BrushRef Brush::create(MAP::Brush const &brush, Geometry const &geometry)
+{
     auto result = Brush::create();
-    for (auto const &plane : brush.planes)
+    for (size_t i = 0; i < brush.planes.size(); ++i)
     {
-        auto const face = Face::create(plane, vertices);
-        result->_faces.push_back(face);
-        result->signal_child_added().emit(face);
+        auto const face = Face::create(brush.planes.at(i), geometry.at(i));
+        result->_add_face(face);
     }
     return result;
 }
@@ -68,11 +87,41 @@ BrushRef Brush::create(MAP::Brush const &brush)
 BrushRef Brush::create(RMF::Solid const &solid)
 {
     auto result = Brush::create();
+    result->visgroup_index = solid.visgroup_index;
+    result->color = solid.color;
     for (auto const &map_face : solid.faces)
     {
         auto face = Face::create(map_face);
-        result->_faces.push_back(face);
-        result->signal_child_added().emit(face);
+        result->_add_face(face);
+    }
+    return result;
+}
+
+BrushRef Brush::create(
+    CSG::Solid const &solid,
+    std::vector<FaceRef> const &faces)
+{
+    auto result = Brush::create();
+    for (auto const &side : solid.sides)
+    {
+        MAP::Plane plane{};
+        if (side.tag < faces.size())
+        {
+            plane = *faces.at(side.tag).get();
+        }
+        else
+        {
+            auto const &points = side.polygon;
+            plane.miptex
+                = faces.empty() ? "" : faces.front()->get_texture().name();
+            plane.s = glm::normalize(points.at(0) - points.at(1));
+            plane.t = glm::normalize(points.at(2) - points.at(1));
+            plane.offsets = {0.0f, 0.0f};
+            plane.rotation = 0.0f;
+            plane.scale = {1.0f, 1.0f};
+        }
+        auto const face = Face::create(plane, side.polygon);
+        result->_add_face(face);
     }
     return result;
 }
@@ -80,6 +129,7 @@ BrushRef Brush::create(RMF::Solid const &solid)
 Brush::Brush()
 : Glib::ObjectBase{typeid(Brush)}
 , Lua::Referenceable{}
+, color{random_color()}
 {
     signal_removed().connect(sigc::mem_fun(*this, &Brush::on_removed));
 }
@@ -102,6 +152,56 @@ Brush::operator MAP::Brush() const
     return out;
 }
 
+std::shared_ptr<std::string const> Brush::map_text() const
+{
+    if (!_map_text)
+    {
+        std::ostringstream text{};
+        MAP::MAPWriter{text}.write(*map_data());
+        _map_text = std::make_shared<std::string const>(text.str());
+    }
+    return _map_text;
+}
+
+std::shared_ptr<MAP::Brush const> Brush::map_data() const
+{
+    if (!_map_data)
+    {
+        _map_data = std::make_shared<MAP::Brush const>(
+            static_cast<MAP::Brush>(*this));
+    }
+    return _map_data;
+}
+
+Brush::operator RMF::Solid() const
+{
+    RMF::Solid out{};
+    out.visgroup_index = visgroup_index;
+    out.color = color;
+    for (auto const &face : _faces)
+    {
+        out.faces.push_back(*face.get());
+    }
+    return out;
+}
+
+CSG::Solid Brush::to_solid(size_t first_tag) const
+{
+    std::vector<CSG::Side> sides{};
+    for (size_t i = 0; i < _faces.size(); ++i)
+    {
+        MAP::Plane const plane = *_faces[i].get();
+        sides.push_back(
+            CSG::Side{HalfPlane{plane.a, plane.b, plane.c}, first_tag + i});
+    }
+    auto solid = CSG::make_solid(sides);
+    if (!solid)
+    {
+        throw std::runtime_error{"brush has no volume"};
+    }
+    return solid.value();
+}
+
 std::vector<FaceRef> Brush::faces() const
 {
     return _faces;
@@ -155,3 +255,27 @@ void Brush::on_removed()
 {
     select(false);
 }
+
+void Brush::_add_face(FaceRef const &face)
+{
+    // Bound with mem_fun, so the connections are dropped along with the
+    // brush even if something else keeps the face alive.
+    auto const changed = sigc::mem_fun(*this, &Brush::_on_face_changed);
+    face->signal_vertices_changed().connect(changed);
+    face->property_texture().signal_changed().connect(changed);
+    face->property_u().signal_changed().connect(changed);
+    face->property_v().signal_changed().connect(changed);
+    face->property_shift().signal_changed().connect(changed);
+    face->property_scale().signal_changed().connect(changed);
+    face->property_rotation().signal_changed().connect(changed);
+
+    _faces.push_back(face);
+    signal_child_added().emit(face);
+}
+
+void Brush::_on_face_changed()
+{
+    _map_text.reset();
+    _map_data.reset();
+    _signal_changed.emit();
+}
@@ -1,6 +1,6 @@
 /**
  * Brush.hpp - Editor::Brush.
- * Copyright (C) 2023 Trevor Last
+ * Copyright (C) 2023-2024 Trevor Last
  *
  *  This program is free software: you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -21,6 +21,7 @@
 
 #include "Face.hpp"
 
+#include <csg/csg.hpp>
 #include <editor/interfaces/EditorObject.hpp>
 #include <files/map/map.hpp>
 #include <files/rmf/rmf.hpp>
@@ -31,6 +32,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace Sickle::Editor
@@ -51,6 +53,21 @@ namespace Sickle::Editor
     , public Lua::Referenceable
     {
     public:
+        /**
+         * Face polygons of a brush, one per plane, in the same order as the
+         * planes.
+         */
+        using Geometry = std::vector<std::vector<glm::vec3>>;
+
+        /**
+         * Calculate the face polygons for MAP format brush data. This doesn't
+         * touch any GObjects, so it is safe to call from any thread.
+         *
+         * @param brush MAP brush to calculate the geometry of.
+         * @return Polygons for each of the brush's planes.
+         */
+        static Geometry compute_geometry(MAP::Brush const &brush);
+
         /**
          * Create a new empty brush. You probably don't want to do this.
          */
@@ -67,14 +84,84 @@ namespace Sickle::Editor
          */
         static BrushRef create(MAP::Brush const &brush);
 
+        /**
+         * Create a new brush from MAP format brush data, using geometry
+         * already calculated by compute_geometry().
+         */
+        static BrushRef create(
+            MAP::Brush const &brush,
+            Geometry const &geometry);
+
         /**
          * Create a new brush from RMF format brush data.
          */
         static BrushRef create(RMF::Solid const &solid);
 
+        /**
+         * Create a new brush from a CSG solid.
+         *
+         * @param solid The solid to make the brush from.
+         * @param faces Faces to copy texture information from. Each side of
+         *              SOLID copies the face its tag indexes. Sides with any
+         *              other tag get the first face's texture, with the
+         *              texture aligned to the side.
+         */
+        static BrushRef create(
+            CSG::Solid const &solid,
+            std::vector<FaceRef> const &faces);
+
         virtual ~Brush();
 
         operator MAP::Brush() const;
+        operator RMF::Solid() const;
+
+        /** Visgroup the brush belongs to, or 0 for none. */
+        int visgroup_index{0};
+        /** Display color. */
+        RMF::Color color;
+
+        /**
+         * Emitted when any of the brush's faces change shape or texture
+         * information.
+         */
+        auto &signal_changed() { return _signal_changed; }
+
+        /**
+         * Get the brush as .map text, exactly as MAP::MAPWriter would write
+         * it. The text is cached, and only regenerated after the brush
+         * changes. Regenerating creates a new string, so text returned
+         * earlier stays valid and unchanged.
+         *
+         * @return The brush's .map text.
+         */
+        std::shared_ptr<std::string const> map_text() const;
+
+        /**
+         * Get the brush's cached .map text without regenerating it.
+         *
+         * @return The text from the last call to map_text(), or null if the
+         *         brush has changed since then.
+         */
+        auto cached_map_text() const { return _map_text; }
+
+        /**
+         * Get the brush as MAP data. The data is immutable and shared until
+         * the brush changes, so it can be handed to another thread. Brushes
+         * prepare it when added to an entity.
+         *
+         * @return The brush's MAP data.
+         */
+        std::shared_ptr<MAP::Brush const> map_data() const;
+
+        /**
+         * Get the brush as a CSG solid.
+         *
+         * @param first_tag Each side is tagged with the index of the face it
+         *                  came from, plus this offset.
+         * @return The brush's solid.
+         * @throw std::runtime_error if the brush has no volume.
+         */
+        CSG::Solid to_solid(size_t first_tag = 0) const;
 
         /**
          * Get a list of faces associated with this brush.
@@ -108,11 +195,13 @@ namespace Sickle::Editor
         void on_removed();
 
     private:
+        sigc::signal<void()> _signal_changed{};
+
         std::vector<FaceRef> _faces{};
-        // TODO:
-        // - visgroup id
-        // - color
-        // ^ these are only used by worldspawn brushes?
+        mutable std::shared_ptr<std::string const> _map_text{};
+        mutable std::shared_ptr<MAP::Brush const> _map_data{};
+        void _add_face(FaceRef const &face);
+        void _on_face_changed();
     };
 } // namespace Sickle::Editor
 
@@ -19,4 +19,5 @@
 #include "Brush.hpp"
 #include "Entity.hpp"
 #include "Face.hpp"
+#include "Group.hpp"
 #include "World.hpp"
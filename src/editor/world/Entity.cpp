@@ -20,12 +20,21 @@
 
 #include <config/appid.hpp>
 #include <editor/core/gamedefinition/GameDefinition.hpp>
+#include <files/map/mapsaver.hpp>
 
 #include <algorithm>
 #include <iostream> // temp
+#include <sstream>
 
 using namespace Sickle::Editor;
 
+/** Hand out a revision number which hasn't been used before. */
+static uint64_t next_revision()
+{
+    static uint64_t revision = 0;
+    return ++revision;
+}
+
 std::shared_ptr<EntityPropertyDefinition> Entity::origin_definition{
     std::make_shared<EntityPropertyDefinition>(
         "origin",
@@ -39,6 +48,18 @@ EntityRef Entity::create(std::string const &classname)
 }
 
 EntityRef Entity::create(MAP::Entity const &entity)
+{
+    std::vector<Brush::Geometry> geometry{};
+    for (auto const &brush : entity.brushes)
+    {
+        geometry.push_back(Brush::compute_geometry(brush));
+    }
+    return create(entity, geometry);
+}
+
+EntityRef Entity::create(
+    MAP::Entity const &entity,
+    std::vector<Brush::Geometry> const &geometry)
 {
     auto e = create(entity.properties.at("classname"));
     for (auto const &kv : entity.properties)
@@ -48,9 +69,9 @@ EntityRef Entity::create(MAP::Entity const &entity)
             e->set_property(kv.first, kv.second);
         }
     }
-    for (auto const &brush : entity.brushes)
+    for (size_t i = 0; i < entity.brushes.size(); ++i)
     {
-        e->add_brush(Brush::create(brush));
+        e->add_brush(Brush::create(entity.brushes.at(i), geometry.at(i)));
     }
     return e;
 }
@@ -58,6 +79,8 @@ EntityRef Entity::create(MAP::Entity const &entity)
 EntityRef Entity::create(RMF::Entity const &entity)
 {
     auto e = create(entity.classname);
+    e->visgroup_index = entity.visgroup_index;
+    e->color = entity.color;
     for (auto const &kv : entity.kv_pairs)
     {
         e->set_property(kv.first, kv.second);
@@ -81,8 +104,11 @@ EntityRef Entity::create(RMF::Entity const &entity)
 Entity::Entity(std::string const &classname)
 : Glib::ObjectBase{typeid(Entity)}
 , _classname{classname}
+, _revision{next_revision()}
 {
     _on_classname_changed();
+    signal_properties_changed().connect(
+        sigc::mem_fun(*this, &Entity::_mark_dirty));
 }
 
 Entity::~Entity()
@@ -108,6 +134,74 @@ Entity::operator MAP::Entity() const
     return out;
 }
 
+Entity::operator RMF::Entity() const
+{
+    RMF::Entity out{};
+    out.visgroup_index = visgroup_index;
+    out.color = color;
+    out.classname = classname();
+    for (auto const &kv : _properties)
+    {
+        out.kv_pairs.insert({kv.first, kv.second.value});
+    }
+    auto const origin = _properties.find("origin");
+    if (origin != _properties.end())
+    {
+        std::istringstream origin_str{origin->second.value};
+        origin_str >> out.position.x >> out.position.y >> out.position.z;
+    }
+    for (auto const &brush : _brushes)
+    {
+        out.brushes.push_back(*brush.get());
+    }
+    return out;
+}
+
+void Entity::MapSnapshot::write(MAP::MAPWriter &writer) const
+{
+    writer.write_raw(*header);
+    for (size_t i = 0; i < brush_texts.size(); ++i)
+    {
+        if (brush_texts[i])
+        {
+            writer.write_raw(*brush_texts[i]);
+        }
+        else
+        {
+            writer.write(*brush_data[i]);
+        }
+        writer.write_raw("\n");
+    }
+    writer.write_raw("}");
+}
+
+void Entity::write_map(MAP::MAPWriter &writer) const
+{
+    MapSnapshot snapshot{_get_map_header(), {}, {}};
+    snapshot.brush_texts.reserve(_brushes.size());
+    for (auto const &brush : _brushes)
+    {
+        snapshot.brush_texts.push_back(brush->map_text());
+    }
+    snapshot.write(writer);
+}
+
+Entity::MapSnapshot Entity::map_snapshot() const
+{
+    MapSnapshot snapshot{_get_map_header(), {}, {}};
+    snapshot.brush_texts.reserve(_brushes.size());
+    snapshot.brush_data.resize(_brushes.size());
+    for (size_t i = 0; i < _brushes.size(); ++i)
+    {
+        snapshot.brush_texts.push_back(_brushes[i]->cached_map_text());
+        if (!snapshot.brush_texts.back())
+        {
+            snapshot.brush_data[i] = _brushes[i]->map_data();
+        }
+    }
+    return snapshot;
+}
+
 EntityClass Entity::classinfo() const
 {
     return _classinfo;
@@ -166,6 +260,12 @@ std::vector<BrushRef> Entity::brushes() const
 void Entity::add_brush(BrushRef const &brush)
 {
     _brushes.push_back(brush);
+    _brush_connections[brush.get()] = brush->signal_changed().connect(
+        sigc::mem_fun(*this, &Entity::_mark_dirty));
+    // Prepared now, while the brush is being built anyway, so snapshots
+    // never have to convert every brush at once.
+    brush->map_data();
+    _mark_dirty();
     signal_child_added().emit(brush);
 }
 
@@ -177,6 +277,13 @@ void Entity::remove_brush(BrushRef const &brush)
         return;
     }
     _brushes.erase(it);
+    auto const conn = _brush_connections.find(brush.get());
+    if (conn != _brush_connections.end())
+    {
+        conn->second.disconnect();
+        _brush_connections.erase(conn);
+    }
+    _mark_dirty();
     signal_child_removed().emit(brush);
 }
 
@@ -228,3 +335,30 @@ void Entity::_on_classname_changed()
             {origin_definition->name(), Property{origin_definition}});
     }
 }
+
+std::shared_ptr<std::string const> Entity::_get_map_header() const
+{
+    if (!_map_header)
+    {
+        // Format the entity without its brushes, then drop the closing
+        // brace, leaving the opening brace and the properties.
+        MAP::Entity header{};
+        header.properties.insert({"classname", classname()});
+        for (auto const &kv : _properties)
+        {
+            header.properties.insert({kv.first, kv.second.value});
+        }
+        std::ostringstream text{};
+        MAP::MAPWriter{text}.write(header);
+        auto str = text.str();
+        str.pop_back();
+        _map_header = std::make_shared<std::string const>(std::move(str));
+    }
+    return _map_header;
+}
+
+void Entity::_mark_dirty()
+{
+    _map_header.reset();
+    _revision = next_revision();
+}
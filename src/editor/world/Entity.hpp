@@ -24,10 +24,12 @@
 #include <editor/core/gamedefinition/EntityClass.hpp>
 #include <editor/interfaces/EditorObject.hpp>
 #include <files/map/map.hpp>
+#include <files/map/mapsaver.hpp>
 #include <files/rmf/rmf.hpp>
 
 #include <glibmm.h>
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -56,9 +58,76 @@ namespace Sickle::Editor
         static EntityRef create(MAP::Entity const &entity);
         static EntityRef create(RMF::Entity const &entity);
 
+        /**
+         * Create an entity from MAP format data, using brush geometry
+         * already calculated by Brush::compute_geometry().
+         *
+         * @param entity MAP entity data.
+         * @param geometry Geometry for each of the entity's brushes, in the
+         *                 same order as the brushes.
+         */
+        static EntityRef create(
+            MAP::Entity const &entity,
+            std::vector<Brush::Geometry> const &geometry);
+
         virtual ~Entity();
 
         operator MAP::Entity() const;
+        operator RMF::Entity() const;
+
+        /** Visgroup the entity belongs to, or 0 for none. */
+        int visgroup_index{0};
+        /** Display color. */
+        RMF::Color color{220, 30, 220};
+
+        /**
+         * Pieces of an entity's .map text. Every piece is immutable and
+         * shared, so the snapshot can be written from any thread.
+         */
+        struct MapSnapshot
+        {
+            /** The opening brace and properties. */
+            std::shared_ptr<std::string const> header;
+            /** Each brush's cached text, or null where it isn't cached. */
+            std::vector<std::shared_ptr<std::string const>> brush_texts;
+            /** Each brush's data, used where its text isn't cached. */
+            std::vector<std::shared_ptr<MAP::Brush const>> brush_data;
+
+            /**
+             * Write the entity, exactly as MAP::MAPWriter would. Brushes
+             * without cached text are formatted here.
+             *
+             * @param writer Where to write the text.
+             */
+            void write(MAP::MAPWriter &writer) const;
+        };
+
+        /**
+         * Write the entity as .map text, exactly as MAP::MAPWriter would.
+         * The header and each brush's text are cached separately, so only
+         * the parts which changed since the last call are formatted again.
+         *
+         * @param writer Where to write the text.
+         */
+        void write_map(MAP::MAPWriter &writer) const;
+
+        /**
+         * Take a snapshot of the entity's .map text without formatting any
+         * brushes. Unchanged brushes share their cached text, and changed
+         * ones share their immutable MAP data.
+         *
+         * @return The snapshot.
+         */
+        MapSnapshot map_snapshot() const;
+
+        /**
+         * Get a number which changes whenever the entity's properties or
+         * brushes change. Revisions are never reused, even across
+         * entities, so comparing lists of them detects any change.
+         *
+         * @return The entity's current revision.
+         */
+        auto revision() const { return _revision; }
 
         /** Emitted when a property is added, deleted, or changes value. */
         auto &signal_properties_changed() { return _signal_properties_changed; }
@@ -180,8 +249,14 @@ namespace Sickle::Editor
         std::string _classname;
         std::unordered_map<std::string, Property> _properties{};
         std::vector<BrushRef> _brushes{};
+        std::unordered_map<Brush *, sigc::connection> _brush_connections{};
+
+        mutable std::shared_ptr<std::string const> _map_header{};
+        uint64_t _revision;
 
         void _on_classname_changed();
+        std::shared_ptr<std::string const> _get_map_header() const;
+        void _mark_dirty();
     };
 } // namespace Sickle::Editor
 
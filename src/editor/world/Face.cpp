@@ -1,6 +1,6 @@
 /**
  * Face.cpp - Editor::Face.
- * Copyright (C) 2023 Trevor Last
+ * Copyright (C) 2023-2024 Trevor Last
  *
  *  This program is free software: you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -106,18 +106,22 @@ FaceRef Face::create(
 {
     Glib::RefPtr ptr{new Face{}};
 
-    ptr->set_texture(""); // TODO
+    ptr->set_texture({}); // TODO
     ptr->set_shift({0.0, 0.0});
     ptr->set_scale({1.0, 1.0});
     ptr->set_rotation(0.0);
 
     // Build Face by finding all the vertices that lie on each plane.
+    std::vector<Classification> sides(brush_vertices.size());
+    classify(plane, PointBlock{brush_vertices}, sides.data());
     auto &vertices = ptr->_vertices;
-    std::copy_if(
-        brush_vertices.cbegin(),
-        brush_vertices.cend(),
-        std::back_inserter(vertices),
-        [&plane](auto v) { return plane.isPointOnPlane(v); });
+    for (size_t i = 0; i < brush_vertices.size(); ++i)
+    {
+        if (sides[i] == ON)
+        {
+            vertices.push_back(brush_vertices[i]);
+        }
+    }
 
     if (vertices.size() < 3)
     {
@@ -138,40 +142,22 @@ FaceRef Face::create(
 
 FaceRef Face::create(
     MAP::Plane const &plane,
-    std::unordered_set<glm::vec3> const &brush_vertices)
+    std::vector<glm::vec3> const &vertices)
 {
     Glib::RefPtr ptr{new Face()};
 
-    ptr->set_texture(plane.miptex);
+    ptr->set_texture(Textures::TextureId{plane.miptex});
     ptr->set_u(plane.s);
     ptr->set_v(plane.t);
     ptr->set_shift(plane.offsets);
     ptr->set_scale(plane.scale);
     ptr->set_rotation(plane.rotation);
 
-    // Build Face by finding all the vertices that lie on each plane.
-    auto &vertices = ptr->_vertices;
-
-    HalfPlane const mp{plane.a, plane.b, plane.c};
-    assert(mp.isPointOnPlane(plane.a));
-    assert(mp.isPointOnPlane(plane.b));
-    assert(mp.isPointOnPlane(plane.c));
-
-    std::copy_if(
-        brush_vertices.cbegin(),
-        brush_vertices.cend(),
-        std::back_inserter(vertices),
-        [&mp](auto v) { return mp.isPointOnPlane(v); });
-
     if (vertices.size() < 3)
     {
         throw std::runtime_error{"not enough points for a face"};
     }
-
-    std::sort(
-        vertices.begin(),
-        vertices.end(),
-        VectorLessCounterClockwise{mp, vertices});
+    ptr->_vertices = vertices;
 
     return ptr;
 }
@@ -180,7 +166,7 @@ FaceRef Face::create(RMF::Face const &face)
 {
     Glib::RefPtr ptr{new Face()};
 
-    ptr->set_texture(face.texture_name);
+    ptr->set_texture(Textures::TextureId{face.texture_name});
     ptr->set_u({face.texture_u.x, face.texture_u.y, face.texture_u.z});
     ptr->set_v({face.texture_v.x, face.texture_v.y, face.texture_v.z});
     ptr->set_shift({face.texture_x_shift, face.texture_y_shift});
@@ -205,7 +191,7 @@ FaceRef Face::create(RMF::Face const &face)
 Face::Face()
 :   Glib::ObjectBase{typeid(Face)}
 ,   Lua::Referenceable{}
-,   _prop_texture{*this, "texture", ""}
+,   _prop_texture{*this, "texture", 0}
 ,   _prop_u{*this, "u", {}}
 ,   _prop_v{*this, "v", {}}
 ,   _prop_shift{*this, "shift", {}}
@@ -221,7 +207,7 @@ Face::operator MAP::Plane() const
         abc[2],
         abc[1],
         abc[0],
-        get_texture(),
+        get_texture().name(),
         get_u(),
         get_v(),
         get_shift(),
@@ -229,6 +215,35 @@ Face::operator MAP::Plane() const
         get_scale()};
 }
 
+Face::operator RMF::Face() const
+{
+    RMF::Face out{};
+    out.texture_name = get_texture().name();
+    auto const u = get_u();
+    auto const v = get_v();
+    auto const shift = get_shift();
+    auto const scale = get_scale();
+    out.texture_u = {u.x, u.y, u.z};
+    out.texture_x_shift = shift.x;
+    out.texture_v = {v.x, v.y, v.z};
+    out.texture_y_shift = shift.y;
+    out.texture_rotation = get_rotation();
+    out.texture_x_scale = scale.x;
+    out.texture_y_scale = scale.y;
+
+    // RMF stores verts sorted clockwise.
+    for (auto it = _vertices.crbegin(); it != _vertices.crend(); ++it)
+    {
+        out.vertices.push_back({it->x, it->y, it->z});
+    }
+    auto const abc = get_plane_points();
+    for (size_t i = 0; i < 3; ++i)
+    {
+        out.plane[i] = {abc[2 - i].x, abc[2 - i].y, abc[2 - i].z};
+    }
+    return out;
+}
+
 std::array<glm::vec3, 3> Face::get_plane_points() const
 {
     return {_vertices.at(0), _vertices.at(1), _vertices.at(2)};
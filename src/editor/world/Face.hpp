@@ -1,6 +1,6 @@
 /**
  * Face.hpp - Editor::Face.
- * Copyright (C) 2023 Trevor Last
+ * Copyright (C) 2023-2024 Trevor Last
  *
  *  This program is free software: you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -21,6 +21,7 @@
 
 #include <convexhull/convexhull.hpp>
 #include <editor/interfaces/EditorObject.hpp>
+#include <editor/textures/TextureId.hpp>
 #include <files/map/map.hpp>
 #include <files/rmf/rmf.hpp>
 #include <se-lua/utils/Referenceable.hpp>
@@ -43,7 +44,9 @@ namespace Sickle::Editor
      * A Face is a flat 3D plane.
      *
      * Brushes are made up of several faces. Each face has texture information
-     * associated with it, used for rendering the face in-game.
+     * associated with it, used for rendering the face in-game. The texture is
+     * stored as an interned TextureId, since large maps have many faces
+     * sharing a few textures.
      */
     class Face
     : public EditorObject
@@ -54,16 +57,24 @@ namespace Sickle::Editor
             HalfPlane const &plane,
             std::vector<glm::vec3> const &brush_vertices);
 
+        /**
+         * Create a face from MAP format plane data.
+         *
+         * @param plane The plane's texture information.
+         * @param vertices Vertices of the face, sorted counterclockwise.
+         */
         static FaceRef create(
             MAP::Plane const &plane,
-            std::unordered_set<glm::vec3> const &brush_vertices);
+            std::vector<glm::vec3> const &vertices);
 
         static FaceRef create(RMF::Face const &face);
 
         virtual ~Face() = default;
 
         operator MAP::Plane() const;
+        operator RMF::Face() const;
 
+        /** The texture, as a TextureId index. */
         auto property_texture() { return _prop_texture.get_proxy(); };
 
         auto property_texture() const { return _prop_texture.get_proxy(); };
@@ -88,7 +99,10 @@ namespace Sickle::Editor
 
         auto property_rotation() const { return _prop_rotation.get_proxy(); };
 
-        auto get_texture() const { return _prop_texture.get_value(); };
+        auto get_texture() const
+        {
+            return Textures::TextureId::from_index(_prop_texture.get_value());
+        };
 
         auto get_u() const { return _prop_u.get_value(); };
 
@@ -100,9 +114,9 @@ namespace Sickle::Editor
 
         auto get_rotation() const { return _prop_rotation.get_value(); };
 
-        void set_texture(std::string const &value)
+        void set_texture(Textures::TextureId value)
         {
-            return _prop_texture.set_value(value);
+            return _prop_texture.set_value(value.index());
         };
 
         void set_u(glm::vec3 const &value) { return _prop_u.set_value(value); };
@@ -146,7 +160,8 @@ namespace Sickle::Editor
         Face();
 
     private:
-        Glib::Property<std::string> _prop_texture;
+        // Stored as a plain index, which GValue holds inline.
+        Glib::Property<unsigned int> _prop_texture;
         Glib::Property<glm::vec3> _prop_u, _prop_v;
         Glib::Property<glm::vec2> _prop_shift;
         Glib::Property<glm::vec2> _prop_scale;
@@ -0,0 +1,190 @@
+/**
+ * Group.cpp - Editor Group class.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Group.hpp"
+
+#include <config/appid.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+using namespace Sickle::Editor;
+
+GroupRef Group::create()
+{
+    return Glib::RefPtr{new Group{}};
+}
+
+Group::Group()
+: Glib::ObjectBase{typeid(Group)}
+{
+    property_selected().signal_changed().connect(
+        sigc::mem_fun(*this, &Group::_on_selected_changed));
+}
+
+Group::~Group()
+{
+    for (auto &[member, connection] : _connections)
+    {
+        connection.disconnect();
+    }
+    for (auto const &child : _groups)
+    {
+        signal_child_removed().emit(child);
+    }
+}
+
+std::vector<EditorObjectRef> Group::members() const
+{
+    std::vector<EditorObjectRef> out{};
+    out.reserve(_brushes.size() + _entities.size());
+    for (auto const &brush : _brushes)
+    {
+        out.push_back(brush);
+    }
+    for (auto const &entity : _entities)
+    {
+        out.push_back(entity);
+    }
+    return out;
+}
+
+void Group::add_brush(BrushRef const &brush)
+{
+    _brushes.push_back(brush);
+    _watch(brush.get());
+}
+
+void Group::add_entity(EntityRef const &entity)
+{
+    _entities.push_back(entity);
+    _watch(entity.get());
+}
+
+void Group::add_group(GroupRef const &group)
+{
+    _groups.push_back(group);
+    signal_child_added().emit(group);
+}
+
+void Group::remove_brush(BrushRef const &brush)
+{
+    auto const it = std::find(_brushes.begin(), _brushes.end(), brush);
+    if (it != _brushes.end())
+    {
+        _unwatch(brush.get());
+        _brushes.erase(it);
+    }
+}
+
+void Group::remove_entity(EntityRef const &entity)
+{
+    auto const it = std::find(_entities.begin(), _entities.end(), entity);
+    if (it != _entities.end())
+    {
+        _unwatch(entity.get());
+        _entities.erase(it);
+    }
+}
+
+void Group::remove_group(GroupRef const &group)
+{
+    auto const it = std::find(_groups.begin(), _groups.end(), group);
+    if (it != _groups.end())
+    {
+        _groups.erase(it);
+        signal_child_removed().emit(group);
+    }
+}
+
+/* ---[ EditorObject interface ]--- */
+Glib::ustring Group::name() const
+{
+    std::stringstream ss{};
+    ss << "group " << this;
+    return Glib::ustring{ss.str()};
+}
+
+Glib::RefPtr<Gdk::Pixbuf> Group::icon() const
+{
+    return Gdk::Pixbuf::create_from_resource(SE_GRESOURCE_PREFIX
+                                             "icons/outliner/group.png");
+}
+
+std::vector<EditorObjectRef> Group::children() const
+{
+    std::vector<EditorObjectRef> out{};
+    for (auto const &group : _groups)
+    {
+        out.push_back(group);
+    }
+    return out;
+}
+
+void Group::_watch(EditorObject *member)
+{
+    // Bind a raw pointer, since a reference held by the member's own signal
+    // would keep it alive forever.
+    _connections[member] = member->signal_removed().connect(sigc::bind(
+        sigc::mem_fun(*this, &Group::_on_member_removed),
+        member));
+}
+
+void Group::_unwatch(EditorObject *member)
+{
+    auto const it = _connections.find(member);
+    if (it != _connections.end())
+    {
+        it->second.disconnect();
+        _connections.erase(it);
+    }
+}
+
+void Group::_on_member_removed(EditorObject *member)
+{
+    _unwatch(member);
+    auto const is_member = [member](auto const &ref)
+    { return static_cast<EditorObject *>(ref.get()) == member; };
+    _brushes.erase(
+        std::remove_if(_brushes.begin(), _brushes.end(), is_member),
+        _brushes.end());
+    _entities.erase(
+        std::remove_if(_entities.begin(), _entities.end(), is_member),
+        _entities.end());
+}
+
+void Group::_on_selected_changed()
+{
+    // The property notifies even when it's set to its current value, which
+    // the outliner does for every row. Only pass on real changes, so that
+    // deselecting an unselected group doesn't deselect its members.
+    auto const selected = is_selected();
+    if (selected == _was_selected)
+    {
+        return;
+    }
+    _was_selected = selected;
+    for (auto const &member : members())
+    {
+        member->select(selected);
+    }
+    for (auto const &group : _groups)
+    {
+        group->select(selected);
+    }
+}
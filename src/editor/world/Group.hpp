@@ -0,0 +1,104 @@
+/**
+ * Group.hpp - Editor Group class.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_EDITOR_WORLD_GROUP_HPP
+#define SE_EDITOR_WORLD_GROUP_HPP
+
+#include "Entity.hpp"
+
+#include <editor/interfaces/EditorObject.hpp>
+#include <files/rmf/rmf.hpp>
+
+#include <glibmm.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace Sickle::Editor
+{
+    class Group;
+    using GroupRef = Glib::RefPtr<Group>;
+
+    /**
+     * Groups collect brushes, entities and other groups, as in Worldcraft.
+     *
+     * Groups don't own their members. Brushes stay in their entity, and
+     * entities stay in the world, so the World -> Entity -> Brush tree is
+     * unchanged. A group's children are only its nested groups, while its
+     * brushes and entities are listed by members() without being reparented.
+     * When a member is removed from the world, it is also removed from its
+     * group.
+     *
+     * Selecting or deselecting a group does the same to all of its members
+     * and nested groups.
+     */
+    class Group : public EditorObject
+    {
+    public:
+        static GroupRef create();
+
+        virtual ~Group();
+
+        /** Visgroup the group belongs to, or 0 for none. */
+        int visgroup_index{0};
+        /** Display color. */
+        RMF::Color color{};
+
+        auto &brushes() const { return _brushes; }
+        auto &entities() const { return _entities; }
+        auto &groups() const { return _groups; }
+
+        /**
+         * Get the group's brushes and entities. Unlike children(), these
+         * keep their place in the World -> Entity -> Brush tree.
+         *
+         * @return The group's direct members.
+         */
+        std::vector<EditorObjectRef> members() const;
+
+        void add_brush(BrushRef const &brush);
+        void add_entity(EntityRef const &entity);
+        void add_group(GroupRef const &group);
+
+        void remove_brush(BrushRef const &brush);
+        void remove_entity(EntityRef const &entity);
+        void remove_group(GroupRef const &group);
+
+        // EditorObject interface
+        virtual Glib::ustring name() const override;
+        virtual Glib::RefPtr<Gdk::Pixbuf> icon() const override;
+        virtual std::vector<EditorObjectRef> children() const override;
+
+    protected:
+        Group();
+
+    private:
+        std::vector<BrushRef> _brushes{};
+        std::vector<EntityRef> _entities{};
+        std::vector<GroupRef> _groups{};
+        std::unordered_map<EditorObject *, sigc::connection> _connections{};
+        bool _was_selected{false};
+
+        void _watch(EditorObject *member);
+        void _unwatch(EditorObject *member);
+        void _on_member_removed(EditorObject *member);
+        void _on_selected_changed();
+    };
+} // namespace Sickle::Editor
+
+#endif
@@ -18,6 +18,12 @@
 
 #include "World.hpp"
 
+#include <files/map/mapsaver.hpp>
+#include <utils/ParallelFor.hpp>
+
+#include <algorithm>
+#include <unordered_set>
+
 using namespace Sickle::Editor;
 
 WorldRef World::create()
@@ -28,24 +34,46 @@ WorldRef World::create()
 WorldRef World::create(MAP::Map const &map)
 {
     auto world = World::create();
-    for (auto const &entity : map.entities)
+    world->_add_map_entities(map.entities);
+    return world;
+}
+
+WorldRef World::load_map(
+    std::string const &path,
+    SlotBatchLoaded const &on_batch)
+{
+    // Entities are converted in batches as they are parsed, so the whole
+    // MAP::Map never has to be in memory at once. Each batch holds enough
+    // brushes to be worth spreading across threads.
+    constexpr size_t BATCH_BRUSHES = 1024;
+
+    auto world = World::create();
+    std::vector<MAP::Entity> batch{};
+    size_t batch_brushes = 0;
+    auto const add_batch = [&world, &batch, &batch_brushes, &on_batch]()
     {
-        if (entity.properties.at("classname") == "worldspawn")
+        world->_add_map_entities(batch);
+        batch.clear();
+        batch_brushes = 0;
+        if (on_batch)
         {
-            auto worldspawn = world->worldspawn();
-            for (auto const &kv : entity.properties)
-            {
-                worldspawn->set_property(kv.first, kv.second);
-            }
-            for (auto const &b : entity.brushes)
-            {
-                worldspawn->add_brush(Brush::create(b));
-            }
+            on_batch(world);
         }
-        else
+    };
+    MAP::load_entities(
+        path,
+        [&batch, &batch_brushes, &add_batch](MAP::Entity &&entity)
         {
-            world->add_entity(Entity::create(entity));
-        }
+            batch_brushes += entity.brushes.size();
+            batch.push_back(std::move(entity));
+            if (batch_brushes >= BATCH_BRUSHES)
+            {
+                add_batch();
+            }
+        });
+    if (!batch.empty())
+    {
+        add_batch();
     }
     return world;
 }
@@ -60,24 +88,53 @@ WorldRef World::create(RMF::RichMap const &map)
         worldspawn->set_property(kv.first, kv.second);
     }
     // worldspawn->set_property("classname", map.worldspawn_name);
+    world->_rmf_extras = {
+        map.visgroups,
+        map.paths,
+        map.active_camera,
+        map.cameras};
 
-    std::stack<RMF::Group> groups{};
-    groups.push(map.objects);
-    while (!groups.empty())
+    // Groups are visited through pointers into MAP, so no part of the tree
+    // is copied. Each is paired with the editor group its contents go into,
+    // or null for the world itself.
+    std::vector<std::pair<RMF::Group const *, GroupRef>> stack{
+        {&map.objects, nullptr}};
+    while (!stack.empty())
     {
-        auto group = groups.top();
-        groups.pop();
-        for (auto const &brush : group.brushes)
+        auto const [group, editor_group] = stack.back();
+        stack.pop_back();
+        for (auto const &solid : group->brushes)
         {
-            worldspawn->add_brush(Brush::create(brush));
+            auto const brush = Brush::create(solid);
+            worldspawn->add_brush(brush);
+            if (editor_group)
+            {
+                editor_group->add_brush(brush);
+            }
         }
-        for (auto const &entity : group.entities)
+        for (auto const &rmf_entity : group->entities)
         {
-            world->add_entity(Entity::create(entity));
+            auto const entity = Entity::create(rmf_entity);
+            world->add_entity(entity);
+            if (editor_group)
+            {
+                editor_group->add_entity(entity);
+            }
         }
-        for (auto group2 : group.groups)
+        for (auto const &child : group->groups)
         {
-            groups.push(group2);
+            auto const child_group = Group::create();
+            child_group->visgroup_index = child.visgroup_index;
+            child_group->color = child.color;
+            if (editor_group)
+            {
+                editor_group->add_group(child_group);
+            }
+            else
+            {
+                world->add_group(child_group);
+            }
+            stack.emplace_back(&child, child_group);
         }
     }
 
@@ -100,6 +157,10 @@ World::~World()
     {
         signal_child_removed().emit(entity);
     }
+    for (auto const &group : _groups)
+    {
+        signal_child_removed().emit(group);
+    }
 }
 
 World::operator MAP::Map() const
@@ -112,6 +173,81 @@ World::operator MAP::Map() const
     return out;
 }
 
+World::operator RMF::RichMap() const
+{
+    RMF::RichMap out{};
+    out.version = 2.2f;
+    out.worldspawn_name = "worldspawn";
+    out.visgroups = _rmf_extras.visgroups;
+    out.paths = _rmf_extras.paths;
+    out.active_camera = _rmf_extras.active_camera;
+    out.cameras = _rmf_extras.cameras;
+
+    // Grouped objects are written inside their groups, so they're skipped
+    // at the top level.
+    std::unordered_set<EditorObject const *> grouped{};
+    std::vector<std::pair<Group const *, RMF::Group *>> stack{};
+    // Child lists are sized up front so the pointers stay valid.
+    out.objects.groups.resize(_groups.size());
+    for (size_t i = 0; i < _groups.size(); ++i)
+    {
+        stack.emplace_back(_groups[i].get(), &out.objects.groups[i]);
+    }
+    while (!stack.empty())
+    {
+        auto const [group, rmf_group] = stack.back();
+        stack.pop_back();
+        rmf_group->visgroup_index = group->visgroup_index;
+        rmf_group->color = group->color;
+        for (auto const &brush : group->brushes())
+        {
+            rmf_group->brushes.push_back(*brush.get());
+            grouped.insert(brush.get());
+        }
+        for (auto const &entity : group->entities())
+        {
+            rmf_group->entities.push_back(*entity.get());
+            grouped.insert(entity.get());
+        }
+        auto const &children = group->groups();
+        rmf_group->groups.resize(children.size());
+        for (size_t i = 0; i < children.size(); ++i)
+        {
+            stack.emplace_back(children[i].get(), &rmf_group->groups[i]);
+        }
+    }
+
+    for (auto const &entity : _entities)
+    {
+        if (entity == _worldspawn)
+        {
+            out.worldspawn_properties = entity->properties();
+            for (auto const &brush : entity->brushes())
+            {
+                if (!grouped.count(brush.get()))
+                {
+                    out.objects.brushes.push_back(*brush.get());
+                }
+            }
+        }
+        else if (!grouped.count(entity.get()))
+        {
+            out.objects.entities.push_back(*entity.get());
+        }
+    }
+    return out;
+}
+
+void World::write_map(std::ostream &out) const
+{
+    MAP::MAPWriter writer{out};
+    for (auto const &entity : _entities)
+    {
+        entity->write_map(writer);
+        writer.write_raw("\n");
+    }
+}
+
 void World::add_entity(EntityRef const &entity)
 {
     if (entity->classname() == "worldspawn")
@@ -142,6 +278,27 @@ void World::remove_entity(EntityRef const &entity)
     signal_child_removed().emit(entity);
 }
 
+void World::add_group(GroupRef const &group)
+{
+    _groups.push_back(group);
+    signal_child_added().emit(group);
+}
+
+void World::remove_group(GroupRef const &group)
+{
+    auto const it = std::find(_groups.cbegin(), _groups.cend(), group);
+    if (it != _groups.cend())
+    {
+        _groups.erase(it);
+        signal_child_removed().emit(group);
+    }
+}
+
+void World::set_rmf_extras(RMFExtras const &extras)
+{
+    _rmf_extras = extras;
+}
+
 void World::remove_brush(BrushRef const &brush)
 {
     for (auto &entity : _entities)
@@ -150,6 +307,212 @@ void World::remove_brush(BrushRef const &brush)
     }
 }
 
+void World::clip_brushes(
+    std::vector<BrushRef> const &brushes,
+    HalfPlane const &plane,
+    ClipKeep keep)
+{
+    for (auto const &brush : brushes)
+    {
+        auto const [below, above] = CSG::split(brush->to_solid(), plane);
+        std::vector<BrushRef> pieces{};
+        if (below && keep != ClipKeep::ABOVE)
+        {
+            pieces.push_back(Brush::create(below.value(), brush->faces()));
+        }
+        if (above && keep != ClipKeep::BELOW)
+        {
+            pieces.push_back(Brush::create(above.value(), brush->faces()));
+        }
+        _replace_brush(brush, pieces);
+    }
+}
+
+void World::carve(std::vector<BrushRef> const &cutters)
+{
+    // Carved faces copy the texture of the cutter face that made them, so
+    // number every cutter face first, followed by the carved brush's faces.
+    std::vector<FaceRef> cutter_faces{};
+    std::vector<CSG::Solid> cutter_solids{};
+    for (auto const &cutter : cutters)
+    {
+        cutter_solids.push_back(cutter->to_solid(cutter_faces.size()));
+        auto const faces = cutter->faces();
+        cutter_faces.insert(cutter_faces.end(), faces.cbegin(), faces.cend());
+    }
+
+    // Cheap bounding box test, so brushes nowhere near the cutters don't
+    // have to be converted to solids.
+    auto const near_cutters = [&cutter_solids](BrushRef const &brush)
+    {
+        auto const vertices = brush->faces().front()->get_vertices();
+        glm::vec3 mins{vertices.front()}, maxs{vertices.front()};
+        for (auto const &face : brush->faces())
+        {
+            for (auto const &vertex : face->get_vertices())
+            {
+                mins = glm::min(mins, vertex);
+                maxs = glm::max(maxs, vertex);
+            }
+        }
+        for (auto const &cutter : cutter_solids)
+        {
+            if (glm::all(glm::lessThan(mins, cutter.maxs))
+                && glm::all(glm::lessThan(cutter.mins, maxs)))
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    for (auto const &entity : _entities)
+    {
+        for (auto const &brush : entity->brushes())
+        {
+            if (std::find(cutters.cbegin(), cutters.cend(), brush)
+                    != cutters.cend()
+                || brush->faces().empty() || !near_cutters(brush))
+            {
+                continue;
+            }
+
+            std::vector<CSG::Solid> pieces{
+                brush->to_solid(cutter_faces.size())};
+            bool carved = false;
+            for (auto const &cutter : cutter_solids)
+            {
+                std::vector<CSG::Solid> next{};
+                for (auto const &piece : pieces)
+                {
+                    if (CSG::intersects(piece, cutter))
+                    {
+                        auto const result = CSG::subtract(piece, cutter);
+                        next.insert(next.end(), result.cbegin(), result.cend());
+                        carved = true;
+                    }
+                    else
+                    {
+                        next.push_back(piece);
+                    }
+                }
+                pieces = std::move(next);
+            }
+            if (!carved)
+            {
+                continue;
+            }
+
+            auto faces = cutter_faces;
+            auto const brush_faces = brush->faces();
+            faces.insert(faces.end(), brush_faces.cbegin(), brush_faces.cend());
+
+            std::vector<BrushRef> replacements{};
+            for (auto const &piece : pieces)
+            {
+                replacements.push_back(Brush::create(piece, faces));
+            }
+            _replace_brush(brush, replacements);
+        }
+    }
+}
+
+void World::hollow_brushes(
+    std::vector<BrushRef> const &brushes,
+    float thickness)
+{
+    for (auto const &brush : brushes)
+    {
+        auto const walls = CSG::hollow(brush->to_solid(), thickness);
+        if (walls.empty())
+        {
+            continue;
+        }
+        std::vector<BrushRef> replacements{};
+        for (auto const &wall : walls)
+        {
+            replacements.push_back(Brush::create(wall, brush->faces()));
+        }
+        _replace_brush(brush, replacements);
+    }
+}
+
+void World::merge_brushes(std::vector<BrushRef> const &brushes)
+{
+    struct Mergeable
+    {
+        EntityRef owner;
+        std::vector<FaceRef> faces;
+        CSG::Solid solid;
+        std::vector<BrushRef> sources;
+    };
+
+    // Tags index into the faces of whichever brushes went into a solid, so
+    // merging two solids means offsetting the second one's tags.
+    std::vector<Mergeable> items{};
+    for (auto const &brush : brushes)
+    {
+        auto const owner = _find_owner(brush);
+        if (owner)
+        {
+            items.push_back(
+                {owner, brush->faces(), brush->to_solid(), {brush}});
+        }
+    }
+
+    // Keep merging pairs until nothing else can be merged.
+    for (bool merged_any = true; merged_any;)
+    {
+        merged_any = false;
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            for (size_t j = i + 1; j < items.size(); ++j)
+            {
+                auto &a = items[i];
+                auto &b = items[j];
+                if (a.owner != b.owner)
+                {
+                    continue;
+                }
+
+                auto b_solid = b.solid;
+                for (auto &side : b_solid.sides)
+                {
+                    side.tag += a.faces.size();
+                }
+                auto merged = CSG::merge(a.solid, b_solid);
+                if (!merged)
+                {
+                    continue;
+                }
+
+                a.solid = std::move(merged.value());
+                a.faces.insert(a.faces.end(), b.faces.cbegin(), b.faces.cend());
+                a.sources.insert(
+                    a.sources.end(),
+                    b.sources.cbegin(),
+                    b.sources.cend());
+                items.erase(items.begin() + j);
+                merged_any = true;
+                --j;
+            }
+        }
+    }
+
+    for (auto const &item : items)
+    {
+        if (item.sources.size() < 2)
+        {
+            continue;
+        }
+        for (auto const &source : item.sources)
+        {
+            item.owner->remove_brush(source);
+        }
+        item.owner->add_brush(Brush::create(item.solid, item.faces));
+    }
+}
+
 EntityRef World::worldspawn()
 {
     return _worldspawn;
@@ -182,9 +545,93 @@ std::vector<EditorObjectRef> World::children() const
     {
         out.push_back(entity);
     }
+    for (auto const &group : _groups)
+    {
+        out.push_back(group);
+    }
     return out;
 }
 
+void World::_add_map_entities(std::vector<MAP::Entity> const &entities)
+{
+    // Map opening happens in two phases. First, the brush geometry is
+    // calculated. This is pure math and makes up most of the work, so it is
+    // spread across all cores. Second, the GObjects are built from the
+    // results. This has to happen on the main thread since it emits signals.
+    std::vector<std::pair<size_t, size_t>> brushes{};
+    std::vector<std::vector<Brush::Geometry>> geometry{};
+    geometry.reserve(entities.size());
+    for (size_t e = 0; e < entities.size(); ++e)
+    {
+        auto const count = entities[e].brushes.size();
+        for (size_t b = 0; b < count; ++b)
+        {
+            brushes.emplace_back(e, b);
+        }
+        geometry.emplace_back(count);
+    }
+
+    parallel_for(
+        brushes.size(),
+        [&entities, &brushes, &geometry](size_t i)
+        {
+            auto const [e, b] = brushes[i];
+            geometry[e][b] = Brush::compute_geometry(entities[e].brushes[b]);
+        });
+
+    for (size_t e = 0; e < entities.size(); ++e)
+    {
+        auto const &entity = entities[e];
+        if (entity.properties.at("classname") == "worldspawn")
+        {
+            auto const spawn = worldspawn();
+            for (auto const &kv : entity.properties)
+            {
+                spawn->set_property(kv.first, kv.second);
+            }
+            for (size_t b = 0; b < entity.brushes.size(); ++b)
+            {
+                spawn->add_brush(
+                    Brush::create(entity.brushes[b], geometry[e][b]));
+            }
+        }
+        else
+        {
+            add_entity(Entity::create(entity, geometry[e]));
+        }
+    }
+}
+
+EntityRef World::_find_owner(BrushRef const &brush) const
+{
+    for (auto const &entity : _entities)
+    {
+        auto const brushes = entity->brushes();
+        if (std::find(brushes.cbegin(), brushes.cend(), brush)
+            != brushes.cend())
+        {
+            return entity;
+        }
+    }
+    return EntityRef{nullptr};
+}
+
+void World::_replace_brush(
+    BrushRef const &brush,
+    std::vector<BrushRef> const &replacements)
+{
+    auto const owner = _find_owner(brush);
+    if (!owner)
+    {
+        return;
+    }
+    owner->remove_brush(brush);
+    for (auto const &replacement : replacements)
+    {
+        owner->add_brush(replacement);
+    }
+}
+
 void World::_on_worldspawn_removed()
 {
     _conn_worldspawn_removed.disconnect();
@@ -21,13 +21,17 @@
 
 #include "Brush.hpp"
 #include "Entity.hpp"
+#include "Group.hpp"
 
 #include <files/map/map.hpp>
 #include <files/rmf/rmf.hpp>
 
 #include <glibmm.h>
 
+#include <functional>
 #include <memory>
+#include <ostream>
+#include <string>
 #include <vector>
 
 namespace Sickle::Editor
@@ -39,7 +43,8 @@ namespace Sickle::Editor
      * World represents a toplevel 'Map'.
      *
      * Worlds consist of a tree-like structure, with the world acting as root.
-     * The next layer are the Entities, then the Brushes.
+     * The next layer are the Entities, then the Brushes. Groups sit beside
+     * the Entities, and only hold references to their members.
      *
      * All worlds have at least one entity, the worldspawn. This entity
      * contains all the physical world geometry.
@@ -51,9 +56,39 @@ namespace Sickle::Editor
         static WorldRef create(MAP::Map const &map);
         static WorldRef create(RMF::RichMap const &map);
 
+        /** Called with the world each time a batch of entities is added. */
+        using SlotBatchLoaded = std::function<void(WorldRef const &)>;
+
+        /**
+         * Load a .map file. Unlike create(MAP::Map const &), the whole
+         * MAP::Map is never held in memory. Entities are added to the world
+         * in batches as they are parsed, and ON_BATCH sees the world after
+         * each batch, so the first brushes can be used before the rest of
+         * the file has been parsed.
+         *
+         * @param path Path to the .map file.
+         * @param on_batch Called on the calling thread after each batch is
+         *                 added, if set.
+         * @throw MAP::LoadError if the file couldn't be loaded. Batches added
+         *        before the error will already have been passed to ON_BATCH.
+         */
+        static WorldRef load_map(
+            std::string const &path,
+            SlotBatchLoaded const &on_batch = {});
+
         virtual ~World();
 
         operator MAP::Map() const;
+        operator RMF::RichMap() const;
+
+        /**
+         * Write the world out as a .map file. The output is the same as
+         * MAP::save() on the converted world, but entities which haven't
+         * changed since the last write reuse their cached text.
+         *
+         * @param out Stream to write to.
+         */
+        void write_map(std::ostream &out) const;
 
         /**
          * Get a list of entities in the world.
@@ -77,6 +112,58 @@ namespace Sickle::Editor
          */
         void remove_entity(EntityRef const &entity);
 
+        /**
+         * Get the world's toplevel groups. Groups loaded from .rmf files
+         * keep their nesting. Toplevel groups are also children of the
+         * world, after the entities.
+         *
+         * @return A list of toplevel groups.
+         */
+        auto &groups() const { return _groups; }
+
+        /**
+         * Add a toplevel group. Its members should already be in the world.
+         *
+         * @param group The group to add.
+         */
+        void add_group(GroupRef const &group);
+
+        /**
+         * Remove a toplevel group. Its members stay in the world.
+         *
+         * @param group The group to remove.
+         */
+        void remove_group(GroupRef const &group);
+
+        /**
+         * Parts of an .rmf file which the editor doesn't use itself. They're
+         * kept from the file the world was loaded from, so that saving it as
+         * an .rmf again doesn't lose them.
+         */
+        struct RMFExtras
+        {
+            std::vector<RMF::VisGroup> visgroups{};
+            std::vector<RMF::Path> paths{};
+            /** Index into cameras, or -1 for none. */
+            int active_camera{-1};
+            std::vector<RMF::Camera> cameras{};
+        };
+
+        /**
+         * Get the .rmf sections kept from the file the world was loaded
+         * from. Empty for worlds which weren't loaded from an .rmf.
+         *
+         * @return The kept sections.
+         */
+        auto &rmf_extras() const { return _rmf_extras; }
+
+        /**
+         * Replace the kept .rmf sections.
+         *
+         * @param extras The sections to write out with the world.
+         */
+        void set_rmf_extras(RMFExtras const &extras);
+
         /**
          * Remove a brush from the world.
          *
@@ -85,6 +172,57 @@ namespace Sickle::Editor
          */
         void remove_brush(BrushRef const &brush);
 
+        /** Which parts of a brush to keep after clipping it. */
+        enum class ClipKeep
+        {
+            /** Keep the part below the plane. */
+            BELOW,
+            /** Keep the part above the plane. */
+            ABOVE,
+            /** Keep both parts, as separate brushes. */
+            BOTH,
+        };
+
+        /**
+         * Cut brushes along a plane.
+         *
+         * @param brushes The brushes to clip.
+         * @param plane Plane to cut along.
+         * @param keep Which parts of the brushes to keep.
+         */
+        void clip_brushes(
+            std::vector<BrushRef> const &brushes,
+            HalfPlane const &plane,
+            ClipKeep keep);
+
+        /**
+         * Carve the cutter brushes out of every other brush in the world
+         * which they overlap. The cutters themselves are left untouched.
+         *
+         * @param cutters Brushes to carve with.
+         */
+        void carve(std::vector<BrushRef> const &cutters);
+
+        /**
+         * Hollow out brushes, replacing each with walls of the given
+         * thickness. Brushes too thin to hollow are left as they are.
+         *
+         * @param brushes The brushes to hollow.
+         * @param thickness Thickness of the walls.
+         * @throw std::invalid_argument if THICKNESS is not positive.
+         */
+        void hollow_brushes(
+            std::vector<BrushRef> const &brushes,
+            float thickness);
+
+        /**
+         * Merge brushes together wherever the result would still be convex.
+         * Only brushes belonging to the same entity are merged.
+         *
+         * @param brushes The brushes to merge.
+         */
+        void merge_brushes(std::vector<BrushRef> const &brushes);
+
         /**
          * Get the world's worldspawn entity.
          *
@@ -103,8 +241,15 @@ namespace Sickle::Editor
     private:
         EntityRef _worldspawn{nullptr};
         std::vector<EntityRef> _entities{};
+        std::vector<GroupRef> _groups{};
+        RMFExtras _rmf_extras{};
         sigc::connection _conn_worldspawn_removed{};
 
+        void _add_map_entities(std::vector<MAP::Entity> const &entities);
+        EntityRef _find_owner(BrushRef const &brush) const;
+        void _replace_brush(
+            BrushRef const &brush,
+            std::vector<BrushRef> const &replacements);
         void _on_worldspawn_removed();
         void _add_worldspawn();
         void _replace_worldspawn(EntityRef const &entity);
@@ -0,0 +1,698 @@
+/**
+ * WorldCache.cpp - Binary cache of loaded worlds.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "WorldCache.hpp"
+
+#include <utils/MappedFile.hpp>
+
+#include <glibmm/miscutils.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+using namespace Sickle::Editor;
+
+/*
+ * Cache file layout. All values are stored in native byte order, since cache
+ * files never leave the machine that wrote them.
+ *
+ * Header:
+ *   char[4]  "SEWC"
+ *   u32      FORMAT_VERSION
+ *   u64      source file hash
+ *   u64      source file size
+ *   u64      entity count
+ * Entity:
+ *   string   classname
+ *   i32      visgroup index
+ *   u8[3]    color
+ *   u32      property count, followed by key and value strings
+ *   u32      brush count, followed by the brushes
+ * After the entities:
+ *   u32      toplevel group count, followed by the groups
+ *   u32      visgroup count, followed by the visgroups
+ *   u32      path count, followed by the paths
+ *   i32      active camera
+ *   u32      camera count, followed by f32[6] eye and look per camera
+ * Group:
+ *   i32      visgroup index
+ *   u8[3]    color
+ *   u32      brush count, followed by u32 entity and brush indices
+ *   u32      entity count, followed by u32 entity indices
+ *   u32      child group count, followed by the groups
+ * Brush:
+ *   i32      visgroup index
+ *   u8[3]    color
+ *   u32      face count, followed by the faces
+ * Face:
+ *   string   texture
+ *   f32[11]  u axis, v axis, shift, scale, rotation
+ *   u32      vertex count, followed by f32[3] per vertex
+ * VisGroup:
+ *   string   name
+ *   u8[3]    color
+ *   i32      index
+ *   u8       visible
+ * Path:
+ *   string   name
+ *   string   class
+ *   i32      type
+ *   u32      corner count, followed by the corners
+ * Corner:
+ *   f32[3]   position
+ *   i32      index
+ *   string   name override
+ *   u32      property count, followed by key and value strings
+ * String:
+ *   u32      length, followed by the characters
+ */
+static constexpr char MAGIC[4] = {'S', 'E', 'W', 'C'};
+/** Bump whenever the layout or the loaders' output changes. */
+static constexpr uint32_t FORMAT_VERSION = 3;
+/** Older caches are deleted once there are more than this many. */
+static constexpr size_t MAX_CACHES = 16;
+
+/** Thrown when a cache file is truncated or corrupt. */
+struct CacheError : std::runtime_error
+{
+    CacheError()
+    : std::runtime_error{"invalid world cache"}
+    {
+    }
+};
+
+/**
+ * Fast non-cryptographic 64-bit hash. Four independent lanes are mixed so the
+ * multiplies can run in parallel, which keeps this well ahead of disk speed.
+ */
+static uint64_t hash_bytes(std::string_view data)
+{
+    constexpr uint64_t K1 = 0x9E3779B97F4A7C15ull;
+    constexpr uint64_t K2 = 0xC2B2AE3D27D4EB4Full;
+    auto const rotl
+        = [](uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+    auto const mix = [&rotl](uint64_t h, uint64_t w)
+    { return rotl(h ^ (w * K2), 31) * K1; };
+
+    uint64_t lanes[4] = {K1, K2, ~K1, ~K2};
+    auto p = data.data();
+    auto const end = p + data.size();
+    for (; end - p >= 32; p += 32)
+    {
+        for (size_t i = 0; i < 4; ++i)
+        {
+            uint64_t w;
+            std::memcpy(&w, p + 8 * i, sizeof(w));
+            lanes[i] = mix(lanes[i], w);
+        }
+    }
+    uint64_t h = data.size();
+    for (auto const lane : lanes)
+    {
+        h = mix(h, lane);
+    }
+    for (; p != end; ++p)
+    {
+        h = mix(h, static_cast<unsigned char>(*p));
+    }
+
+    // Final avalanche, from splitmix64.
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return h;
+}
+
+/** Bounds-checked reads from a cache file. */
+class CacheReader
+{
+public:
+    explicit CacheReader(std::string_view data)
+    : _cur{data.data()}
+    , _end{data.data() + data.size()}
+    {
+    }
+
+    template<typename T>
+    T read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        _require(sizeof(T));
+        T value;
+        std::memcpy(&value, _cur, sizeof(T));
+        _cur += sizeof(T);
+        return value;
+    }
+
+    std::string read_string()
+    {
+        auto const length = read<uint32_t>();
+        _require(length);
+        std::string str{_cur, length};
+        _cur += length;
+        return str;
+    }
+
+    glm::vec2 read_vec2()
+    {
+        auto const x = read<float>();
+        return {x, read<float>()};
+    }
+
+    glm::vec3 read_vec3()
+    {
+        auto const x = read<float>();
+        auto const y = read<float>();
+        return {x, y, read<float>()};
+    }
+
+    /** Read a count of items, each at least MIN_SIZE bytes long. */
+    uint32_t read_count(size_t min_size)
+    {
+        auto const count = read<uint32_t>();
+        _require(count * min_size);
+        return count;
+    }
+
+    bool at_end() const { return _cur == _end; }
+
+private:
+    char const *_cur;
+    char const *const _end;
+
+    void _require(size_t bytes) const
+    {
+        if (static_cast<size_t>(_end - _cur) < bytes)
+        {
+            throw CacheError{};
+        }
+    }
+};
+
+/** Builds a cache file in memory. */
+class CacheWriter
+{
+public:
+    template<typename T>
+    void write(T const &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        _data.append(reinterpret_cast<char const *>(&value), sizeof(T));
+    }
+
+    void write_string(std::string const &str)
+    {
+        write(static_cast<uint32_t>(str.size()));
+        _data.append(str);
+    }
+
+    void write_vec2(glm::vec2 const &v)
+    {
+        write(v.x);
+        write(v.y);
+    }
+
+    void write_vec3(glm::vec3 const &v)
+    {
+        write(v.x);
+        write(v.y);
+        write(v.z);
+    }
+
+    /** Take the written data, leaving the writer empty. */
+    std::string take() { return std::move(_data); }
+
+private:
+    std::string _data{};
+};
+
+static BrushRef read_brush(CacheReader &in)
+{
+    // Smallest possible face: empty texture name, no vertices.
+    constexpr size_t MIN_FACE_SIZE = 4 + 11 * 4 + 4;
+
+    auto const visgroup_index = in.read<int32_t>();
+    auto const color = in.read<RMF::Color>();
+    auto const face_count = in.read_count(MIN_FACE_SIZE);
+    MAP::Brush brush{};
+    Brush::Geometry geometry{};
+    brush.planes.reserve(face_count);
+    geometry.reserve(face_count);
+    for (uint32_t f = 0; f < face_count; ++f)
+    {
+        MAP::Plane plane{};
+        plane.miptex = in.read_string();
+        plane.s = in.read_vec3();
+        plane.t = in.read_vec3();
+        plane.offsets = in.read_vec2();
+        plane.scale = in.read_vec2();
+        plane.rotation = in.read<float>();
+
+        auto const vertex_count = in.read_count(3 * sizeof(float));
+        std::vector<glm::vec3> vertices{};
+        vertices.reserve(vertex_count);
+        for (uint32_t v = 0; v < vertex_count; ++v)
+        {
+            vertices.push_back(in.read_vec3());
+        }
+        brush.planes.push_back(std::move(plane));
+        geometry.push_back(std::move(vertices));
+    }
+    auto const result = Brush::create(brush, geometry);
+    result->visgroup_index = visgroup_index;
+    result->color = color;
+    return result;
+}
+
+static void write_brush(CacheWriter &out, BrushRef const &brush)
+{
+    out.write(static_cast<int32_t>(brush->visgroup_index));
+    out.write(brush->color);
+    auto const faces = brush->faces();
+    out.write(static_cast<uint32_t>(faces.size()));
+    for (auto const &face : faces)
+    {
+        out.write_string(face->get_texture().name());
+        out.write_vec3(face->get_u());
+        out.write_vec3(face->get_v());
+        out.write_vec2(face->get_shift());
+        out.write_vec2(face->get_scale());
+        out.write(face->get_rotation());
+
+        auto const vertices = face->get_vertices();
+        out.write(static_cast<uint32_t>(vertices.size()));
+        for (auto const &vertex : vertices)
+        {
+            out.write_vec3(vertex);
+        }
+    }
+}
+
+/** Indices of entities and brushes, used to refer to group members. */
+struct MemberIndices
+{
+    std::unordered_map<Entity const *, uint32_t> entities{};
+    std::unordered_map<Brush const *, std::pair<uint32_t, uint32_t>>
+        brushes{};
+};
+
+/** Objects loaded from a cache, in file order. */
+struct Members
+{
+    std::vector<EntityRef> entities{};
+    std::vector<std::vector<BrushRef>> brushes{};
+};
+
+static GroupRef read_group(CacheReader &in, Members const &members)
+{
+    auto const group = Group::create();
+    group->visgroup_index = in.read<int32_t>();
+    group->color = in.read<RMF::Color>();
+
+    auto const brush_count = in.read_count(8);
+    for (uint32_t b = 0; b < brush_count; ++b)
+    {
+        auto const entity = in.read<uint32_t>();
+        auto const brush = in.read<uint32_t>();
+        group->add_brush(members.brushes.at(entity).at(brush));
+    }
+    auto const entity_count = in.read_count(4);
+    for (uint32_t e = 0; e < entity_count; ++e)
+    {
+        group->add_entity(members.entities.at(in.read<uint32_t>()));
+    }
+    auto const group_count = in.read_count(4 + 3 + 12);
+    for (uint32_t g = 0; g < group_count; ++g)
+    {
+        group->add_group(read_group(in, members));
+    }
+    return group;
+}
+
+static void write_group(
+    CacheWriter &out,
+    GroupRef const &group,
+    MemberIndices const &indices)
+{
+    out.write(static_cast<int32_t>(group->visgroup_index));
+    out.write(group->color);
+
+    out.write(static_cast<uint32_t>(group->brushes().size()));
+    for (auto const &brush : group->brushes())
+    {
+        auto const [entity, index] = indices.brushes.at(brush.get());
+        out.write(entity);
+        out.write(index);
+    }
+    out.write(static_cast<uint32_t>(group->entities().size()));
+    for (auto const &entity : group->entities())
+    {
+        out.write(indices.entities.at(entity.get()));
+    }
+    out.write(static_cast<uint32_t>(group->groups().size()));
+    for (auto const &child : group->groups())
+    {
+        write_group(out, child, indices);
+    }
+}
+
+static RMF::Path read_path(CacheReader &in)
+{
+    RMF::Path path{};
+    path.name = in.read_string();
+    path.class_ = in.read_string();
+    path.type = in.read<int32_t>();
+
+    auto const corner_count = in.read_count(12 + 4 + 4 + 4);
+    path.corners.reserve(corner_count);
+    for (uint32_t c = 0; c < corner_count; ++c)
+    {
+        auto &corner = path.corners.emplace_back();
+        corner.position = in.read<RMF::Vector>();
+        corner.index = in.read<int32_t>();
+        corner.name_override = in.read_string();
+        auto const property_count = in.read_count(8);
+        for (uint32_t p = 0; p < property_count; ++p)
+        {
+            auto const key = in.read_string();
+            corner.kv_pairs[key] = in.read_string();
+        }
+    }
+    return path;
+}
+
+static void write_path(CacheWriter &out, RMF::Path const &path)
+{
+    out.write_string(path.name);
+    out.write_string(path.class_);
+    out.write(static_cast<int32_t>(path.type));
+
+    out.write(static_cast<uint32_t>(path.corners.size()));
+    for (auto const &corner : path.corners)
+    {
+        out.write(corner.position);
+        out.write(static_cast<int32_t>(corner.index));
+        out.write_string(corner.name_override);
+        out.write(static_cast<uint32_t>(corner.kv_pairs.size()));
+        for (auto const &kv : corner.kv_pairs)
+        {
+            out.write_string(kv.first);
+            out.write_string(kv.second);
+        }
+    }
+}
+
+static World::RMFExtras read_rmf_extras(CacheReader &in)
+{
+    World::RMFExtras extras{};
+    auto const visgroup_count = in.read_count(4 + 3 + 4 + 1);
+    extras.visgroups.reserve(visgroup_count);
+    for (uint32_t v = 0; v < visgroup_count; ++v)
+    {
+        auto &visgroup = extras.visgroups.emplace_back();
+        visgroup.name = in.read_string();
+        visgroup.color = in.read<RMF::Color>();
+        visgroup.index = in.read<int32_t>();
+        visgroup.visible = in.read<uint8_t>() != 0;
+    }
+
+    auto const path_count = in.read_count(4 + 4 + 4 + 4);
+    extras.paths.reserve(path_count);
+    for (uint32_t p = 0; p < path_count; ++p)
+    {
+        extras.paths.push_back(read_path(in));
+    }
+
+    extras.active_camera = in.read<int32_t>();
+    auto const camera_count = in.read_count(2 * 12);
+    extras.cameras.reserve(camera_count);
+    for (uint32_t c = 0; c < camera_count; ++c)
+    {
+        auto &camera = extras.cameras.emplace_back();
+        camera.eye = in.read<RMF::Vector>();
+        camera.look = in.read<RMF::Vector>();
+    }
+    return extras;
+}
+
+static void write_rmf_extras(
+    CacheWriter &out,
+    World::RMFExtras const &extras)
+{
+    out.write(static_cast<uint32_t>(extras.visgroups.size()));
+    for (auto const &visgroup : extras.visgroups)
+    {
+        out.write_string(visgroup.name);
+        out.write(visgroup.color);
+        out.write(static_cast<int32_t>(visgroup.index));
+        out.write(static_cast<uint8_t>(visgroup.visible));
+    }
+
+    out.write(static_cast<uint32_t>(extras.paths.size()));
+    for (auto const &path : extras.paths)
+    {
+        write_path(out, path);
+    }
+
+    out.write(static_cast<int32_t>(extras.active_camera));
+    out.write(static_cast<uint32_t>(extras.cameras.size()));
+    for (auto const &camera : extras.cameras)
+    {
+        out.write(camera.eye);
+        out.write(camera.look);
+    }
+}
+
+/** Delete the least recently written caches, keeping MAX_CACHES of them. */
+static void prune_caches(std::filesystem::path const &dir)
+{
+    namespace fs = std::filesystem;
+    std::error_code ec{};
+    std::vector<std::pair<fs::file_time_type, fs::path>> caches{};
+    for (auto const &entry : fs::directory_iterator{dir, ec})
+    {
+        if (entry.path().extension() == ".world")
+        {
+            caches.emplace_back(entry.last_write_time(ec), entry.path());
+        }
+    }
+    if (caches.size() <= MAX_CACHES)
+    {
+        return;
+    }
+    std::sort(caches.begin(), caches.end());
+    for (size_t i = 0; i < caches.size() - MAX_CACHES; ++i)
+    {
+        fs::remove(caches[i].second, ec);
+    }
+}
+
+/**
+ * Write DATA to CACHE_PATH, then prune old caches. The file is written under
+ * a temporary name and renamed into place, so an interrupted write can't
+ * leave a half-written cache behind.
+ */
+static void write_cache(
+    std::filesystem::path const &cache_path,
+    std::string const &data)
+{
+    std::error_code ec{};
+    std::filesystem::create_directories(cache_path.parent_path(), ec);
+    auto temp_path = cache_path;
+    temp_path += ".tmp";
+    {
+        std::ofstream file{temp_path, std::ios::out | std::ios::binary};
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!file)
+        {
+            file.close();
+            std::filesystem::remove(temp_path, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(temp_path, cache_path, ec);
+    prune_caches(cache_path.parent_path());
+}
+
+WorldCache::WorldCache(std::string const &source_path)
+{
+    try
+    {
+        MappedFile const source{source_path};
+        _source_hash = hash_bytes(source.view());
+        _source_size = source.size();
+    }
+    catch (std::runtime_error const &)
+    {
+        return;
+    }
+
+    char name[32];
+    std::snprintf(
+        name,
+        sizeof(name),
+        "%016llx.world",
+        static_cast<unsigned long long>(_source_hash));
+    _cache_path = std::filesystem::path{Glib::get_user_cache_dir()}
+                / "sickle" / "worlds" / name;
+    _valid = true;
+}
+
+WorldRef WorldCache::load() const
+{
+    if (!_valid)
+    {
+        return {};
+    }
+
+    try
+    {
+        MappedFile const file{_cache_path.string()};
+        CacheReader in{file.view()};
+
+        auto const magic = in.read<std::array<char, 4>>();
+        if (!std::equal(magic.cbegin(), magic.cend(), MAGIC)
+            || in.read<uint32_t>() != FORMAT_VERSION
+            || in.read<uint64_t>() != _source_hash
+            || in.read<uint64_t>() != _source_size)
+        {
+            return {};
+        }
+
+        auto const world = World::create();
+        Members members{};
+        auto const entity_count = in.read<uint64_t>();
+        for (uint64_t e = 0; e < entity_count; ++e)
+        {
+            auto const classname = in.read_string();
+            bool const is_worldspawn = (classname == "worldspawn");
+            auto const entity = is_worldspawn ? world->worldspawn()
+                                              : Entity::create(classname);
+            entity->visgroup_index = in.read<int32_t>();
+            entity->color = in.read<RMF::Color>();
+
+            auto const property_count = in.read_count(8);
+            for (uint32_t p = 0; p < property_count; ++p)
+            {
+                auto const key = in.read_string();
+                entity->set_property(key, in.read_string());
+            }
+
+            auto const brush_count = in.read_count(4 + 3 + 4);
+            auto &brushes = members.brushes.emplace_back();
+            for (uint32_t b = 0; b < brush_count; ++b)
+            {
+                brushes.push_back(read_brush(in));
+                entity->add_brush(brushes.back());
+            }
+
+            if (!is_worldspawn)
+            {
+                world->add_entity(entity);
+            }
+            members.entities.push_back(entity);
+        }
+
+        auto const group_count = in.read_count(4 + 3 + 12);
+        for (uint32_t g = 0; g < group_count; ++g)
+        {
+            world->add_group(read_group(in, members));
+        }
+        world->set_rmf_extras(read_rmf_extras(in));
+        if (!in.at_end())
+        {
+            return {};
+        }
+        return world;
+    }
+    catch (std::exception const &)
+    {
+        // Missing, truncated or corrupt cache.
+        return {};
+    }
+}
+
+std::future<void> WorldCache::save(WorldRef const &world) const
+{
+    if (!_valid)
+    {
+        return {};
+    }
+
+    CacheWriter out{};
+    for (auto const c : MAGIC)
+    {
+        out.write(c);
+    }
+    out.write(FORMAT_VERSION);
+    out.write(_source_hash);
+    out.write(_source_size);
+    out.write(static_cast<uint64_t>(world->entities().size()));
+    MemberIndices indices{};
+    for (auto const &entity : world->entities())
+    {
+        auto const entity_index
+            = static_cast<uint32_t>(indices.entities.size());
+        indices.entities.emplace(entity.get(), entity_index);
+
+        out.write_string(entity->classname());
+        out.write(static_cast<int32_t>(entity->visgroup_index));
+        out.write(entity->color);
+        auto const properties = entity->properties();
+        out.write(static_cast<uint32_t>(properties.size()));
+        for (auto const &kv : properties)
+        {
+            out.write_string(kv.first);
+            out.write_string(kv.second);
+        }
+        auto const brushes = entity->brushes();
+        out.write(static_cast<uint32_t>(brushes.size()));
+        for (uint32_t b = 0; b < brushes.size(); ++b)
+        {
+            write_brush(out, brushes[b]);
+            indices.brushes.emplace(
+                brushes[b].get(),
+                std::make_pair(entity_index, b));
+        }
+    }
+
+    out.write(static_cast<uint32_t>(world->groups().size()));
+    for (auto const &group : world->groups())
+    {
+        write_group(out, group, indices);
+    }
+    write_rmf_extras(out, world->rmf_extras());
+
+    // The world can only be read on this thread, but writing the file
+    // doesn't need it.
+    return std::async(
+        std::launch::async,
+        [cache_path = _cache_path, data = out.take()]()
+        { write_cache(cache_path, data); });
+}
@@ -0,0 +1,83 @@
+/**
+ * WorldCache.hpp - Binary cache of loaded worlds.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_EDITOR_WORLD_WORLDCACHE_HPP
+#define SE_EDITOR_WORLD_WORLDCACHE_HPP
+
+#include "World.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <string>
+
+namespace Sickle::Editor
+{
+    /**
+     * Binary cache of the world loaded from a map file.
+     *
+     * Loading a large map means parsing it and calculating the polygon of
+     * every face. The cache stores the end result: face polygons, texture
+     * information, entity properties and groups. Reopening the same file
+     * then just maps the cache into memory and copies the data out.
+     *
+     * Caches live in the user's cache directory, and are named after a hash
+     * of the map file's contents. A cache is only used if its hash and size
+     * match the map file, so edited files are always loaded normally.
+     */
+    class WorldCache
+    {
+    public:
+        /**
+         * Find the cache for the map file at SOURCE_PATH. This hashes the
+         * file's contents. If the file can't be read, load() and save() do
+         * nothing.
+         *
+         * @param source_path Path to the .map or .rmf file.
+         */
+        explicit WorldCache(std::string const &source_path);
+
+        /**
+         * Load the world from the cache.
+         *
+         * @return The cached world, or null if there is no usable cache.
+         */
+        WorldRef load() const;
+
+        /**
+         * Write WORLD to the cache. Since the cache is only an optimization,
+         * failures are ignored.
+         *
+         * The world is serialized on the calling thread, and the file is
+         * written on a worker thread.
+         *
+         * @param world The world loaded from the map file.
+         * @return Finishes once the file is written. Destroying it waits
+         *         for the write. Invalid if there was nothing to write.
+         */
+        std::future<void> save(WorldRef const &world) const;
+
+    private:
+        bool _valid{false};
+        uint64_t _source_hash{0};
+        uint64_t _source_size{0};
+        std::filesystem::path _cache_path{};
+    };
+} // namespace Sickle::Editor
+
+#endif
@@ -18,11 +18,37 @@
 
 #include "map.hpp"
 #include "parsing/MAPDriver.hpp"
+#include "parsing/MAPReader.hpp"
+
+#include <utils/MappedFile.hpp>
 
 #include <fstream>
 
-MAP::Map MAP::load(std::string const &path)
+static MappedFile open_file(std::string const &path)
+{
+    try
+    {
+        return MappedFile{path};
+    }
+    catch (std::runtime_error const &)
+    {
+        throw MAP::LoadError{"Failed to open '" + path + "'"};
+    }
+}
+
+MAP::Map MAP::load(std::string const &path, Parser parser)
 {
+    if (parser == Parser::FAST)
+    {
+        auto const file = open_file(path);
+        return MAPReader{file.view()}.read_map();
+    }
+    else if (parser == Parser::PARALLEL)
+    {
+        auto const file = open_file(path);
+        return read_map_parallel(file.view());
+    }
+
     std::ifstream f{path, std::ios::in | std::ios::binary};
     if (!f.is_open())
     {
@@ -32,3 +58,11 @@ MAP::Map MAP::load(std::string const &path)
     driver.parse(f);
     return driver.get_result();
 }
+
+void MAP::load_entities(
+    std::string const &path,
+    std::function<void(Entity &&)> const &callback)
+{
+    auto const file = open_file(path);
+    read_entities_parallel(file.view(), callback);
+}
@@ -22,6 +22,7 @@
 #include <glm/glm.hpp>
 
 #include <array>
+#include <functional>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -97,8 +98,41 @@ namespace MAP
         std::vector<Entity> entities{};
     };
 
-    /** Parse a .map file. */
-    Map load(std::string const &path);
+    /** Parsers which load() can use. */
+    enum class Parser
+    {
+        /** Hand-written parser which reads from a memory-mapped file. */
+        FAST,
+        /** Same as FAST, but splits the file up to parse on every core. */
+        PARALLEL,
+        /** Flex/Bison parser. */
+        FLEX_BISON,
+    };
+
+    /**
+     * Parse a .map file.
+     *
+     * @param path Path to the file.
+     * @param parser Which parser to use. All produce the same result.
+     * @throw LoadError if the file couldn't be opened or parsed.
+     */
+    Map load(std::string const &path, Parser parser = Parser::PARALLEL);
+
+    /**
+     * Parse a .map file a batch of entities at a time, using every core.
+     * Only one batch is held in memory at once, and callers can start
+     * working on the first entities before the rest of the file has been
+     * parsed.
+     *
+     * @param path Path to the file.
+     * @param callback Called with each entity as soon as it has been parsed,
+     *                 in file order.
+     * @throw LoadError if the file couldn't be opened or parsed. Entities
+     *        before the error will already have been passed to CALLBACK.
+     */
+    void load_entities(
+        std::string const &path,
+        std::function<void(Entity &&)> const &callback);
 } // namespace MAP
 
 #endif
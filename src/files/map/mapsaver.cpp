@@ -1,6 +1,6 @@
 /**
  * mapsaver.cpp - Save a map to a .map file.
- * Copyright (C) 2023 Trevor Last
+ * Copyright (C) 2023-2024 Trevor Last
  *
  *  This program is free software: you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -18,7 +18,10 @@
 
 #include "mapsaver.hpp"
 
+#include <algorithm>
+#include <charconv>
 #include <ostream>
+#include <vector>
 
 namespace std
 {
@@ -30,56 +33,182 @@ namespace std
 
     std::ostream &operator<<(std::ostream &os, MAP::Plane const &plane)
     {
-        os << plane.a << ' ' << plane.b << ' ' << plane.c << ' ' << plane.miptex
-           << " [ " << plane.s.x << ' ' << plane.s.y << ' ' << plane.s.z << ' '
-           << plane.offsets.x << " ] "
-           << "[ " << plane.t.x << ' ' << plane.t.y << ' ' << plane.t.z << ' '
-           << plane.offsets.y << " ] " << plane.rotation << ' ' << plane.scale.x
-           << ' ' << plane.scale.y;
+        MAP::MAPWriter{os}.write(plane);
         return os;
     }
 
     std::ostream &operator<<(std::ostream &os, MAP::Brush const &brush)
     {
-        os << "{\n";
-        for (auto const &plane : brush.planes)
-        {
-            os << plane << '\n';
-        }
-        os << '}';
+        MAP::MAPWriter{os}.write(brush);
         return os;
     }
 
     std::ostream &operator<<(std::ostream &os, MAP::Entity const &entity)
     {
-        os << "{\n";
-        os << "\"classname\" \"" << entity.properties.at("classname") << "\"\n";
-        for (auto const &kv : entity.properties)
-        {
-            if (kv.first != "classname")
-            {
-                os << '"' << kv.first << "\" \"" << kv.second << "\"\n";
-            }
-        }
-        for (auto const &brush : entity.brushes)
-        {
-            os << brush << '\n';
-        }
-        os << '}';
+        MAP::MAPWriter{os}.write(entity);
         return os;
     }
 
     std::ostream &operator<<(std::ostream &os, MAP::Map const &map)
     {
-        for (auto const &ent : map.entities)
-        {
-            os << ent << '\n';
-        }
+        MAP::MAPWriter{os}.write(map);
         return os;
     }
 } // namespace std
 
+using namespace MAP;
+
+MAPWriter::MAPWriter(std::ostream &out)
+: _out{out}
+{
+}
+
+MAPWriter::~MAPWriter()
+{
+    flush();
+}
+
+void MAPWriter::write(Map const &map)
+{
+    for (auto const &entity : map.entities)
+    {
+        write(entity);
+        _put('\n');
+    }
+}
+
+void MAPWriter::write(Entity const &entity)
+{
+    _put("{\n\"classname\" \"");
+    _put(entity.properties.at("classname"));
+    _put("\"\n");
+
+    std::vector<decltype(entity.properties)::value_type const *> properties{};
+    properties.reserve(entity.properties.size());
+    for (auto const &kv : entity.properties)
+    {
+        if (kv.first != "classname")
+        {
+            properties.push_back(&kv);
+        }
+    }
+    std::sort(
+        properties.begin(),
+        properties.end(),
+        [](auto const *a, auto const *b) { return a->first < b->first; });
+    for (auto const *kv : properties)
+    {
+        _put('"');
+        _put(kv->first);
+        _put("\" \"");
+        _put(kv->second);
+        _put("\"\n");
+    }
+
+    for (auto const &brush : entity.brushes)
+    {
+        write(brush);
+        _put('\n');
+    }
+    _put('}');
+    _maybe_flush();
+}
+
+void MAPWriter::write(Brush const &brush)
+{
+    _put("{\n");
+    for (auto const &plane : brush.planes)
+    {
+        write(plane);
+        _put('\n');
+    }
+    _put('}');
+    _maybe_flush();
+}
+
+void MAPWriter::write(Plane const &plane)
+{
+    _put(plane.a);
+    _put(' ');
+    _put(plane.b);
+    _put(' ');
+    _put(plane.c);
+    _put(' ');
+    _put(plane.miptex);
+    _put(" [ ");
+    _put(plane.s.x);
+    _put(' ');
+    _put(plane.s.y);
+    _put(' ');
+    _put(plane.s.z);
+    _put(' ');
+    _put(plane.offsets.x);
+    _put(" ] [ ");
+    _put(plane.t.x);
+    _put(' ');
+    _put(plane.t.y);
+    _put(' ');
+    _put(plane.t.z);
+    _put(' ');
+    _put(plane.offsets.y);
+    _put(" ] ");
+    _put(plane.rotation);
+    _put(' ');
+    _put(plane.scale.x);
+    _put(' ');
+    _put(plane.scale.y);
+}
+
+void MAPWriter::write_raw(std::string_view text)
+{
+    _put(text);
+    _maybe_flush();
+}
+
+void MAPWriter::flush()
+{
+    _out.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+    _buffer.clear();
+}
+
+void MAPWriter::_put(char c)
+{
+    _buffer.push_back(c);
+}
+
+void MAPWriter::_put(std::string_view str)
+{
+    _buffer.append(str);
+}
+
+void MAPWriter::_put(float value)
+{
+    // Plenty for the shortest representation of any float.
+    char chars[32];
+    auto const result = std::to_chars(chars, chars + sizeof(chars), value);
+    _buffer.append(chars, result.ptr);
+}
+
+void MAPWriter::_put(Vertex const &vertex)
+{
+    _put("( ");
+    _put(vertex.x);
+    _put(' ');
+    _put(vertex.y);
+    _put(' ');
+    _put(vertex.z);
+    _put(" )");
+}
+
+void MAPWriter::_maybe_flush()
+{
+    if (_buffer.size() >= BLOCK_SIZE)
+    {
+        flush();
+    }
+}
+
 void MAP::save(std::ostream &out, Map const &map)
 {
-    out << map;
+    MAPWriter{out}.write(map);
 }
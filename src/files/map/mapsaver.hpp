@@ -1,6 +1,6 @@
 /**
  * mapsaver.hpp - Save a map to a .map file.
- * Copyright (C) 2023 Trevor Last
+ * Copyright (C) 2023-2024 Trevor Last
  *
  *  This program is free software: you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -22,6 +22,8 @@
 #include "map.hpp"
 
 #include <ostream>
+#include <string>
+#include <string_view>
 
 namespace std
 {
@@ -34,6 +36,49 @@ namespace std
 
 namespace MAP
 {
+    /**
+     * Formats .map text into a buffer, which is written out to a stream in
+     * large blocks. Numbers are written with std::to_chars, so the output
+     * doesn't depend on the locale, and floats are written with the fewest
+     * digits which read back as the same value.
+     *
+     * Output is deterministic: properties are written with "classname"
+     * first, then the rest sorted by key.
+     */
+    class MAPWriter
+    {
+    public:
+        /** Size the buffer grows to before being flushed. */
+        static constexpr size_t BLOCK_SIZE = 1 << 20;
+
+        explicit MAPWriter(std::ostream &out);
+        ~MAPWriter();
+
+        MAPWriter(MAPWriter const &) = delete;
+        MAPWriter &operator=(MAPWriter const &) = delete;
+
+        void write(Map const &map);
+        void write(Entity const &entity);
+        void write(Brush const &brush);
+        void write(Plane const &plane);
+
+        /** Write already-formatted text as-is. */
+        void write_raw(std::string_view text);
+
+        /** Write out anything left in the buffer. */
+        void flush();
+
+    private:
+        std::ostream &_out;
+        std::string _buffer{};
+
+        void _put(char c);
+        void _put(std::string_view str);
+        void _put(float value);
+        void _put(Vertex const &vertex);
+        void _maybe_flush();
+    };
+
     /** Save a map to a .map file. */
     void save(std::ostream &out, Map const &map);
 } // namespace MAP
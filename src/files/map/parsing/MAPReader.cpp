@@ -0,0 +1,563 @@
+/**
+ * MAPReader.cpp - Hand-written .map parser.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "MAPReader.hpp"
+
+#include <utils/ParallelFor.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace MAP;
+
+/** Same as isspace() in the C locale, which is what the flex lexer uses. */
+static bool is_space(char c)
+{
+    return c == ' ' || ('\t' <= c && c <= '\r');
+}
+
+/** Same as isdigit() in the C locale. */
+static bool is_digit(char c)
+{
+    return '0' <= c && c <= '9';
+}
+
+/** Characters allowed in texture names, ie. [[:alnum:][:punct:]]. */
+static bool is_texture_char(char c)
+{
+    return '!' <= c && c <= '~';
+}
+
+MAPReader::MAPReader(std::string_view text)
+: _begin{text.data()}
+, _end{text.data() + text.size()}
+, _cur{_begin}
+{
+}
+
+bool MAPReader::at_end()
+{
+    _skip_whitespace();
+    return _cur == _end;
+}
+
+Entity MAPReader::read_entity()
+{
+    auto entity = read_entity_header();
+    while (_next_is('{'))
+    {
+        entity.brushes.push_back(read_brush());
+    }
+    _expect('}');
+    return entity;
+}
+
+Map MAPReader::read_map()
+{
+    Map map{};
+    while (!at_end())
+    {
+        map.entities.push_back(read_entity());
+    }
+    return map;
+}
+
+Entity MAPReader::read_entity_header()
+{
+    Entity entity{};
+    _expect('{');
+    // At least one property is required.
+    do
+    {
+        auto const key = _string();
+        auto const value = _string();
+        // Later duplicates overwrite earlier ones, same as MAPDriver.
+        entity.properties[std::string{key}] = std::string{value};
+    } while (_next_is('"'));
+    return entity;
+}
+
+Brush MAPReader::read_brush()
+{
+    _expect('{');
+    Brush brush{};
+    brush.planes.reserve(6);
+    do
+    {
+        brush.planes.push_back(_plane());
+    } while (_next_is('('));
+    if (brush.planes.size() < 4)
+    {
+        _error<ParseError>("brush has fewer than 4 planes");
+    }
+    _expect('}');
+    return brush;
+}
+
+void MAPReader::_skip_whitespace()
+{
+    for (;;)
+    {
+        while (_cur != _end && is_space(*_cur))
+        {
+            ++_cur;
+        }
+        // Line comments aren't part of the format, but some editors write
+        // them anyway.
+        if (_end - _cur >= 2 && _cur[0] == '/' && _cur[1] == '/')
+        {
+            _cur = std::find(_cur, _end, '\n');
+            continue;
+        }
+        return;
+    }
+}
+
+void MAPReader::_expect(char c)
+{
+    _skip_whitespace();
+    if (_cur == _end || *_cur != c)
+    {
+        _error<ParseError>(std::string{"expected '"} + c + "'");
+    }
+    ++_cur;
+}
+
+bool MAPReader::_next_is(char c)
+{
+    _skip_whitespace();
+    return _cur != _end && *_cur == c;
+}
+
+float MAPReader::_number()
+{
+    _skip_whitespace();
+    // Match the flex lexer's NUMBER exactly:
+    //   -?[[:digit:]]+(\.[[:digit:]]+)?(e[+-][[:digit:]]+)?
+    // Optional parts are only taken if they're complete. As in the lexer,
+    // whatever follows is left for the next token.
+    auto const skip_digits = [this](char const *p)
+    {
+        while (p != _end && is_digit(*p))
+        {
+            ++p;
+        }
+        return p;
+    };
+    auto const start = _cur;
+    auto p = start;
+    if (p != _end && *p == '-')
+    {
+        ++p;
+    }
+    auto q = skip_digits(p);
+    if (q == p)
+    {
+        _error<ParseError>("expected a number");
+    }
+    p = q;
+    if (p != _end && *p == '.')
+    {
+        q = skip_digits(p + 1);
+        if (q != p + 1)
+        {
+            p = q;
+        }
+    }
+    if (_end - p >= 2 && p[0] == 'e' && (p[1] == '+' || p[1] == '-'))
+    {
+        q = skip_digits(p + 2);
+        if (q != p + 2)
+        {
+            p = q;
+        }
+    }
+
+    float value = 0.0f;
+    auto const [ptr, ec] = std::from_chars(start, p, value);
+    if (ec != std::errc{} || ptr != p)
+    {
+        // The lexer's std::stof() throws on out of range values too.
+        _error<ParseError>("number out of range");
+    }
+    _cur = p;
+    return value;
+}
+
+std::string_view MAPReader::_string()
+{
+    _expect('"');
+    auto const start = _cur;
+    while (_cur != _end && *_cur != '"')
+    {
+        if (*_cur == '\n')
+        {
+            _error<TokenizeError>("unterminated string");
+        }
+        ++_cur;
+    }
+    if (_cur == _end)
+    {
+        _error<TokenizeError>("unterminated string");
+    }
+    std::string_view const str{start, static_cast<size_t>(_cur - start)};
+    ++_cur;
+    return str;
+}
+
+std::string_view MAPReader::_texture()
+{
+    _skip_whitespace();
+    auto const start = _cur;
+    while (_cur != _end && is_texture_char(*_cur))
+    {
+        ++_cur;
+    }
+    if (_cur == start)
+    {
+        _error<ParseError>("expected a texture name");
+    }
+    return {start, static_cast<size_t>(_cur - start)};
+}
+
+Vertex MAPReader::_point()
+{
+    _expect('(');
+    Vertex point{};
+    point.x = _number();
+    point.y = _number();
+    point.z = _number();
+    _expect(')');
+    return point;
+}
+
+std::array<float, 4> MAPReader::_vector()
+{
+    _expect('[');
+    std::array<float, 4> vector{};
+    for (auto &v : vector)
+    {
+        v = _number();
+    }
+    _expect(']');
+    return vector;
+}
+
+Plane MAPReader::_plane()
+{
+    Plane plane{};
+    plane.a = _point();
+    plane.b = _point();
+    plane.c = _point();
+    plane.miptex = _texture();
+    auto const s = _vector();
+    auto const t = _vector();
+    plane.s = {s[0], s[1], s[2]};
+    plane.t = {t[0], t[1], t[2]};
+    plane.offsets = {s[3], t[3]};
+    plane.rotation = _number();
+    plane.scale.x = _number();
+    plane.scale.y = _number();
+    return plane;
+}
+
+template<class E>
+void MAPReader::_error(std::string const &what) const
+{
+    // Positions are only needed for errors, so they aren't tracked while
+    // parsing.
+    auto const line = 1 + std::count(_begin, _cur, '\n');
+    auto line_start = _cur;
+    while (line_start != _begin && line_start[-1] != '\n')
+    {
+        --line_start;
+    }
+    auto const column = 1 + (_cur - line_start);
+    throw E{
+        what + " @ " + std::to_string(line) + ":" + std::to_string(column)};
+}
+
+/** Where an entity and its brushes start in the text. */
+struct EntitySpan
+{
+    char const *begin;
+    std::vector<char const *> brushes;
+    /** The entity's closing brace. */
+    char const *close;
+};
+
+/**
+ * Find where each entity and brush starts. This only tracks braces, so it is
+ * much faster than a full parse, but it doesn't validate anything.
+ *
+ * @return The spans, or nothing if the braces don't match up.
+ */
+static std::optional<std::vector<EntitySpan>> find_spans(std::string_view text)
+{
+    std::vector<EntitySpan> spans{};
+    int depth = 0;
+    // Texture names can contain braces. They always follow a plane's third
+    // point, so remember the last token to know when to expect one.
+    char last = '\0';
+    for (auto p = text.data(), end = p + text.size(); p != end;)
+    {
+        auto const c = *p;
+        if (is_space(c))
+        {
+            ++p;
+        }
+        else if (last == ')' && c != '(')
+        {
+            while (p != end && !is_space(*p))
+            {
+                ++p;
+            }
+            last = 't';
+        }
+        else if (c == '"')
+        {
+            p = std::find(p + 1, end, '"');
+            if (p == end || depth == 0)
+            {
+                return std::nullopt;
+            }
+            ++p;
+            last = c;
+        }
+        else if (c == '/' && end - p >= 2 && p[1] == '/')
+        {
+            p = std::find(p, end, '\n');
+        }
+        else if (c == '{')
+        {
+            if (depth == 0)
+            {
+                spans.push_back({p, {}, nullptr});
+            }
+            else if (depth == 1)
+            {
+                spans.back().brushes.push_back(p);
+            }
+            else
+            {
+                return std::nullopt;
+            }
+            ++depth;
+            ++p;
+            last = c;
+        }
+        else if (c == '}')
+        {
+            if (depth == 0)
+            {
+                return std::nullopt;
+            }
+            if (--depth == 0)
+            {
+                spans.back().close = p;
+            }
+            ++p;
+            last = c;
+        }
+        else if (depth == 0)
+        {
+            return std::nullopt;
+        }
+        else
+        {
+            ++p;
+            last = c;
+        }
+    }
+    if (depth != 0)
+    {
+        return std::nullopt;
+    }
+    return spans;
+}
+
+/** Parse the text between BEGIN and END, which must hold nothing else. */
+template<class Fn>
+static void parse_span(char const *begin, char const *end, Fn const &fn)
+{
+    MAPReader reader{
+        std::string_view{begin, static_cast<size_t>(end - begin)}};
+    fn(reader);
+    if (!reader.at_end())
+    {
+        throw ParseError{"unexpected text in entity"};
+    }
+}
+
+/**
+ * Parse the entities in SPANS from FIRST up to LAST concurrently.
+ *
+ * @throw LoadError if any piece fails to parse. The error's position is
+ *        relative to the start of that piece.
+ */
+static std::vector<Entity> parse_spans(
+    std::vector<EntitySpan> const &spans,
+    size_t first,
+    size_t last)
+{
+    // Worldspawn usually holds most of the brushes, so splitting by entity
+    // alone wouldn't spread the work out. Instead, brushes are parsed in
+    // groups, regardless of which entity they belong to.
+    constexpr size_t GROUP_SIZE = 256;
+
+    std::vector<Entity> entities(last - first);
+    std::vector<std::pair<size_t, size_t>> groups{};
+    for (size_t e = 0; e < entities.size(); ++e)
+    {
+        auto const count = spans[first + e].brushes.size();
+        entities[e].brushes.resize(count);
+        for (size_t b = 0; b < count; b += GROUP_SIZE)
+        {
+            groups.emplace_back(e, b);
+        }
+    }
+
+    parallel_for(
+        entities.size(),
+        [&spans, &entities, first](size_t e)
+        {
+            auto const &span = spans[first + e];
+            auto const header_end
+                = span.brushes.empty() ? span.close : span.brushes.front();
+            parse_span(
+                span.begin,
+                header_end,
+                [&entities, e](MAPReader &reader)
+                {
+                    entities[e].properties
+                        = reader.read_entity_header().properties;
+                });
+        });
+
+    parallel_for(
+        groups.size(),
+        [&spans, &entities, &groups, first](size_t i)
+        {
+            auto const [e, begin] = groups[i];
+            auto const &span = spans[first + e];
+            auto const end = std::min(begin + GROUP_SIZE, span.brushes.size());
+            auto const text_end = (end == span.brushes.size())
+                                    ? span.close
+                                    : span.brushes[end];
+            parse_span(
+                span.brushes[begin],
+                text_end,
+                [&entities, e, begin, end](MAPReader &reader)
+                {
+                    auto &brushes = entities[e].brushes;
+                    for (size_t b = begin; b < end; ++b)
+                    {
+                        brushes[b] = reader.read_brush();
+                    }
+                });
+        });
+    return entities;
+}
+
+void MAP::read_entities_parallel(
+    std::string_view text,
+    std::function<void(Entity &&)> const &callback)
+{
+    // Entities are parsed a batch at a time, so only one batch is held in
+    // memory and the first entities are handed over before the rest of the
+    // file has been parsed. Each batch needs enough brushes to be worth
+    // spreading across threads.
+    constexpr size_t BATCH_SIZE = 16384;
+
+    // Parse serially, skipping entities which were already handed over.
+    auto const read_serial = [&text, &callback](size_t skip)
+    {
+        MAPReader reader{text};
+        for (size_t i = 0; i < skip; ++i)
+        {
+            reader.read_entity();
+        }
+        while (!reader.at_end())
+        {
+            callback(reader.read_entity());
+        }
+    };
+
+    // Splitting the text has a cost, which single threaded parsing doesn't
+    // make up for.
+    if (std::thread::hardware_concurrency() <= 1)
+    {
+        read_serial(0);
+        return;
+    }
+
+    auto const spans = find_spans(text);
+    if (!spans)
+    {
+        // Let the regular parser find the error.
+        read_serial(0);
+        return;
+    }
+
+    for (size_t first = 0; first < spans->size();)
+    {
+        auto last = first;
+        for (size_t size = 0; last < spans->size() && size < BATCH_SIZE;
+             ++last)
+        {
+            size += 1 + spans->at(last).brushes.size();
+        }
+
+        std::vector<Entity> batch{};
+        try
+        {
+            batch = parse_spans(*spans, first, last);
+        }
+        catch (LoadError const &)
+        {
+            // Errors could come from any thread, and their positions are
+            // relative to the piece being parsed. Reparse serially so the
+            // error reported is the first one in the file, with its real
+            // position.
+            read_serial(first);
+            return;
+        }
+
+        for (auto &entity : batch)
+        {
+            callback(std::move(entity));
+        }
+        first = last;
+    }
+}
+
+Map MAP::read_map_parallel(std::string_view text)
+{
+    Map map{};
+    read_entities_parallel(
+        text,
+        [&map](Entity &&entity)
+        {
+            map.entities.push_back(std::move(entity));
+        });
+    return map;
+}
@@ -0,0 +1,113 @@
+/**
+ * MAPReader.hpp - Hand-written .map parser.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MAP_READER_HPP
+#define MAP_READER_HPP
+
+#include "map.hpp"
+
+#include <array>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace MAP
+{
+    /**
+     * Parses .map text directly out of a buffer. Accepts the same grammar as
+     * MAPDriver, but tokens are views into the buffer, so the only copies
+     * made are the strings stored in the output.
+     */
+    class MAPReader
+    {
+    public:
+        /**
+         * @param text The .map text. Must outlive the reader.
+         */
+        explicit MAPReader(std::string_view text);
+
+        /** Check if there are any entities left to read. */
+        bool at_end();
+
+        /**
+         * Read the next entity.
+         *
+         * @throw TokenizeError if the text contains an invalid token.
+         * @throw ParseError if the text doesn't match the .map grammar.
+         */
+        Entity read_entity();
+
+        /** Read every remaining entity. */
+        Map read_map();
+
+        /**
+         * Read the opening brace and properties of an entity. The entity's
+         * brushes and closing brace are left unread.
+         */
+        Entity read_entity_header();
+
+        /** Read a single brush. */
+        Brush read_brush();
+
+    private:
+        char const *const _begin;
+        char const *const _end;
+        char const *_cur;
+
+        void _skip_whitespace();
+        void _expect(char c);
+        bool _next_is(char c);
+
+        float _number();
+        std::string_view _string();
+        std::string_view _texture();
+
+        Vertex _point();
+        std::array<float, 4> _vector();
+        Plane _plane();
+
+        template<class E>
+        [[noreturn]] void _error(std::string const &what) const;
+    };
+
+    /**
+     * Parse .map text using multiple threads. The text is split at entity
+     * and brush boundaries, and the pieces are parsed concurrently. Produces
+     * the same result as MAPReader::read_map().
+     *
+     * @throw TokenizeError if the text contains an invalid token.
+     * @throw ParseError if the text doesn't match the .map grammar.
+     */
+    Map read_map_parallel(std::string_view text);
+
+    /**
+     * Parse .map text using multiple threads, a batch of entities at a time.
+     * Entities are passed to CALLBACK in file order as each batch finishes.
+     *
+     * @param text The .map text.
+     * @param callback Called with each entity, on the calling thread.
+     * @throw TokenizeError if the text contains an invalid token.
+     * @throw ParseError if the text doesn't match the .map grammar. Entities
+     *        before the error will already have been passed to CALLBACK.
+     */
+    void read_entities_parallel(
+        std::string_view text,
+        std::function<void(Entity &&)> const &callback);
+} // namespace MAP
+
+#endif
@@ -1,6 +1,6 @@
 /**
  * rmf.cpp - Rich Map Format data.
- * Copyright (C) 2023 Trevor Last
+ * Copyright (C) 2023-2024 Trevor Last
  *
  *  This program is free software: you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -18,6 +18,10 @@
 
 #include "rmf.hpp"
 
+#include <utils/MappedFile.hpp>
+
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -47,10 +51,10 @@ static void dbg_lo(T arg, Ts... args)
 }
 
 template<typename... Ts>
-static void dbg(std::istream &s, Ts... ts)
+static void dbg(size_t offset, Ts... ts)
 {
     std::stringstream ss{};
-    ss << std::hex << std::setw(8) << std::setfill('0') << s.tellg();
+    ss << std::hex << std::setw(8) << std::setfill('0') << offset;
     dbgstream << ss.str();
     dbg_lo(ts...);
 }
@@ -71,7 +75,7 @@ static void dbg_lo(T arg, Ts... args)
 }
 
 template<typename... Ts>
-void dbg(std::istream &s, Ts... ts)
+static void dbg(size_t offset, Ts... ts)
 {
 }
 #endif
@@ -85,361 +89,711 @@ std::string LoadError::_make_what(std::streampos where, std::string const &what)
     return ss.str();
 }
 
-void rmfloadassert(std::istream &s, bool expr, std::string const &what)
+/**
+ * Reads values out of an in-memory .rmf file. Every read is bounds-checked,
+ * so truncated or corrupt files throw LoadError instead of reading past the
+ * end of the buffer.
+ */
+class RMFReader
 {
-    if (!expr)
+public:
+    explicit RMFReader(std::string_view data)
+    : _begin{data.data()}
+    , _end{data.data() + data.size()}
+    , _cur{_begin}
     {
-        throw RMF::LoadError(s.tellg(), what);
     }
-}
 
-int32_t readInt(std::istream &s)
-{
-    dbg(s, " INT(");
-    uint8_t b[4];
-    s.read(reinterpret_cast<char *>(b), 4);
-    uint32_t r = b[0] | (b[1] << 8) | (b[2] << 16) | (b[3] << 24);
-    dbg_lo(r, ")\n");
-    return r;
-}
+    /** Offset of the next byte to be read. */
+    size_t tell() const { return static_cast<size_t>(_cur - _begin); }
 
-float readFloat(std::istream &s)
-{
-    dbg(s, " FLOAT(");
-    float f;
-    s.read(reinterpret_cast<char *>(&f), 4);
-    dbg_lo(f, ")\n");
-    return f;
-}
+    [[noreturn]] void error(std::string const &what) const
+    {
+        throw LoadError{static_cast<std::streamoff>(tell()), what};
+    }
 
-uint8_t readByte(std::istream &s)
-{
-    dbg(s, " BYTE(");
-    uint8_t b;
-    s.read(reinterpret_cast<char *>(&b), 1);
-    dbg_lo(dbgbyte(b), ")\n");
-    return b;
-}
+    void check(bool expr, std::string const &what) const
+    {
+        if (!expr)
+        {
+            error(what);
+        }
+    }
 
-void readBytes(std::istream &s, std::streamsize n)
-{
-    dbg(s, " BYTES(", n, ")\n");
-    char *b = new char[n];
-    s.read(b, n);
-    delete[] b;
-}
+    int32_t readInt()
+    {
+        dbg(tell(), " INT(");
+        auto const b = reinterpret_cast<uint8_t const *>(_take(4));
+        int32_t const r = static_cast<int32_t>(
+            b[0] | (b[1] << 8) | (b[2] << 16) | (uint32_t{b[3]} << 24));
+        dbg_lo(r, ")\n");
+        return r;
+    }
 
-std::string readString(std::istream &s, std::streamsize n)
-{
-    dbg(s, " STRING(", n, ", \"");
-    char *buf = new char[n + 1];
-    s.read(buf, n);
-    std::string str{buf};
-    dbg_lo(str, "\")\n");
-    delete[] buf;
-    return str;
-}
+    float readFloat()
+    {
+        dbg(tell(), " FLOAT(");
+        float f;
+        std::memcpy(&f, _take(4), 4);
+        dbg_lo(f, ")\n");
+        return f;
+    }
 
-std::string readNString(std::istream &s)
-{
-    dbg(s, " NSTRING(");
-    uint8_t n = 0;
-    s.read(reinterpret_cast<char *>(&n), 1);
-    dbg_lo((int)n, ", \"");
-    char *buf = new char[n + 1];
-    s.read(buf, n);
-    std::string str{buf};
-    dbg_lo(str, "\")\n");
-    delete[] buf;
-    return str;
-}
+    uint8_t readByte()
+    {
+        dbg(tell(), " BYTE(");
+        auto const b = static_cast<uint8_t>(*_take(1));
+        dbg_lo(dbgbyte(b), ")\n");
+        return b;
+    }
+
+    void readBytes(size_t n)
+    {
+        dbg(tell(), " BYTES(", n, ")\n");
+        _take(n);
+    }
+
+    /** Read a fixed-size field holding a null-terminated string. */
+    std::string readString(size_t n)
+    {
+        dbg(tell(), " STRING(", n, ", \"");
+        auto const buf = _take(n);
+        std::string str{buf, strnlen(buf, n)};
+        dbg_lo(str, "\")\n");
+        return str;
+    }
+
+    /** Read a length-prefixed, null-terminated string. */
+    std::string readNString()
+    {
+        dbg(tell(), " NSTRING(");
+        auto const n = readByte();
+        dbg_lo((int)n, ", \"");
+        auto const buf = _take(n);
+        std::string str{buf, strnlen(buf, n)};
+        dbg_lo(str, "\")\n");
+        return str;
+    }
+
+    /**
+     * Read the number of items in a list. Each item takes at least MIN_SIZE
+     * bytes, so counts that couldn't possibly fit in the rest of the file
+     * are rejected before anything is allocated for them.
+     */
+    size_t readCount(size_t min_size)
+    {
+        auto const count = readInt();
+        if (count < 0 || static_cast<size_t>(count) > (_end - _cur) / min_size)
+        {
+            error("Invalid count " + std::to_string(count));
+        }
+        return static_cast<size_t>(count);
+    }
+
+private:
+    char const *const _begin;
+    char const *const _end;
+    char const *_cur;
+
+    char const *_take(size_t n)
+    {
+        // Checked inline rather than with check(), so the message is only
+        // built when it's needed.
+        if (static_cast<size_t>(_end - _cur) < n)
+        {
+            error("Unexpected end of file");
+        }
+        auto const p = _cur;
+        _cur += n;
+        return p;
+    }
+};
 
-Color readColor(std::istream &s)
+// Smallest possible size of each structure, used to sanity check counts.
+static constexpr size_t MIN_OBJECT_SIZE = 1 + 4 + 3 + 4;
+static constexpr size_t MIN_FACE_SIZE = 256 + 4 * 12 + 16 + 4 + 4 * 9;
+static constexpr size_t MIN_VECTOR_SIZE = 3 * 4;
+static constexpr size_t MIN_KV_PAIR_SIZE = 2;
+
+Color readColor(RMFReader &r)
 {
-    dbg(s, " Color(\n");
+    dbg(r.tell(), " Color(\n");
     Color color{};
-    color.r = readByte(s);
-    color.g = readByte(s);
-    color.b = readByte(s);
-    dbg(s, " Color)\n");
+    color.r = r.readByte();
+    color.g = r.readByte();
+    color.b = r.readByte();
+    dbg(r.tell(), " Color)\n");
     return color;
 }
 
-VisGroup readVisGroup(std::istream &s)
+VisGroup readVisGroup(RMFReader &r)
 {
-    dbg(s, " VisGroup(\n");
+    dbg(r.tell(), " VisGroup(\n");
     VisGroup visgroup{};
-    visgroup.name = readString(s, 128);
-    visgroup.color = readColor(s);
-    readByte(s);
-    visgroup.index = readInt(s);
-    visgroup.visible = (readByte(s) != 0);
-    readBytes(s, 3);
-    dbg(s, " VisGroup)\n");
+    visgroup.name = r.readString(128);
+    visgroup.color = readColor(r);
+    r.readByte();
+    visgroup.index = r.readInt();
+    visgroup.visible = (r.readByte() != 0);
+    r.readBytes(3);
+    dbg(r.tell(), " VisGroup)\n");
     return visgroup;
 }
 
-Vector readVector(std::istream &s)
+Vector readVector(RMFReader &r)
 {
-    dbg(s, " Vector(\n");
+    dbg(r.tell(), " Vector(\n");
     Vector vector{};
-    vector.x = readFloat(s);
-    vector.y = readFloat(s);
-    vector.z = readFloat(s);
-    dbg(s, " Vector)\n");
+    vector.x = r.readFloat();
+    vector.y = r.readFloat();
+    vector.z = r.readFloat();
+    dbg(r.tell(), " Vector)\n");
     return vector;
 }
 
-Face readFace(std::istream &s)
+void readKVPairs(
+    RMFReader &r,
+    std::unordered_map<std::string, std::string> &kv_pairs)
 {
-    dbg(s, " Face(\n");
-    Face face{};
-    face.texture_name = readString(s, 256);
-    readFloat(s);
-    face.texture_u = readVector(s);
-    face.texture_x_shift = readFloat(s);
-    face.texture_v = readVector(s);
-    face.texture_y_shift = readFloat(s);
-    face.texture_rotation = readFloat(s);
-    face.texture_x_scale = readFloat(s);
-    face.texture_y_scale = readFloat(s);
-    readBytes(s, 16);
-    auto vertex_count = readInt(s);
-    for (int i = 0; i < vertex_count; ++i)
+    auto const kv_pairs_count = r.readCount(MIN_KV_PAIR_SIZE);
+    for (size_t i = 0; i < kv_pairs_count; ++i)
     {
-        face.vertices.push_back(readVector(s));
+        auto key = r.readNString();
+        kv_pairs[std::move(key)] = r.readNString();
     }
-    face.plane[0] = readVector(s);
-    face.plane[1] = readVector(s);
-    face.plane[2] = readVector(s);
-    dbg(s, " Face)\n");
-    return face;
 }
 
-auto readSolid(std::istream &s, bool withheader = true)
+void readFace(RMFReader &r, Face &face)
 {
-    dbg(s, " Solid(\n");
-    Solid solid{};
-    if (withheader)
+    dbg(r.tell(), " Face(\n");
+    face.texture_name = r.readString(256);
+    r.readFloat();
+    face.texture_u = readVector(r);
+    face.texture_x_shift = r.readFloat();
+    face.texture_v = readVector(r);
+    face.texture_y_shift = r.readFloat();
+    face.texture_rotation = r.readFloat();
+    face.texture_x_scale = r.readFloat();
+    face.texture_y_scale = r.readFloat();
+    r.readBytes(16);
+    auto const vertex_count = r.readCount(MIN_VECTOR_SIZE);
+    face.vertices.reserve(vertex_count);
+    for (size_t i = 0; i < vertex_count; ++i)
     {
-        auto type = readNString(s);
-        rmfloadassert(
-            s,
-            type == "CMapSolid",
-            "Expected CMapSolid, got '" + type + "'");
+        face.vertices.push_back(readVector(r));
     }
-    solid.visgroup_index = readInt(s);
-    solid.color = readColor(s);
-    readBytes(s, 4);
-    auto face_count = readInt(s);
-    for (int32_t i = 0; i < face_count; ++i)
+    face.plane[0] = readVector(r);
+    face.plane[1] = readVector(r);
+    face.plane[2] = readVector(r);
+    dbg(r.tell(), " Face)\n");
+}
+
+void readType(RMFReader &r, char const *expected)
+{
+    auto const type = r.readNString();
+    if (type != expected)
     {
-        solid.faces.push_back(readFace(s));
+        r.error(std::string{"Expected "} + expected + ", got '" + type + "'");
     }
-    dbg(s, " Solid)\n");
-    return solid;
 }
 
-auto readEntity(std::istream &s, bool withheader = true)
+void readSolid(RMFReader &r, Solid &solid, bool withheader = true)
 {
-    dbg(s, " Entity(\n");
-    Entity entity{};
+    dbg(r.tell(), " Solid(\n");
     if (withheader)
     {
-        auto type = readNString(s);
-        rmfloadassert(
-            s,
-            type == "CMapEntity",
-            "Expected CMapEntity, got '" + type + "'");
+        readType(r, "CMapSolid");
     }
-    entity.visgroup_index = readInt(s);
-    entity.color = readColor(s);
-    auto brush_count = readInt(s);
-    for (int32_t i = 0; i < brush_count; ++i)
+    solid.visgroup_index = r.readInt();
+    solid.color = readColor(r);
+    r.readBytes(4);
+    auto const face_count = r.readCount(MIN_FACE_SIZE);
+    solid.faces.resize(face_count);
+    for (auto &face : solid.faces)
+    {
+        readFace(r, face);
+    }
+    dbg(r.tell(), " Solid)\n");
+}
+
+void readEntity(RMFReader &r, Entity &entity, bool withheader = true)
+{
+    dbg(r.tell(), " Entity(\n");
+    if (withheader)
     {
-        entity.brushes.push_back(readSolid(s));
+        readType(r, "CMapEntity");
     }
-    entity.classname = readNString(s);
-    readBytes(s, 4);
-    entity.flags = readInt(s);
-    auto kv_pairs_count = readInt(s);
-    for (int32_t i = 0; i < kv_pairs_count; ++i)
+    entity.visgroup_index = r.readInt();
+    entity.color = readColor(r);
+    auto const brush_count = r.readCount(MIN_OBJECT_SIZE);
+    entity.brushes.resize(brush_count);
+    for (auto &brush : entity.brushes)
     {
-        auto key = readNString(s);
-        auto value = readNString(s);
-        entity.kv_pairs[key] = value;
+        readSolid(r, brush);
     }
-    readBytes(s, 14);
-    entity.position = readVector(s);
-    readBytes(s, 4);
-    dbg(s, " Entity)\n");
-    return entity;
+    entity.classname = r.readNString();
+    r.readBytes(4);
+    entity.flags = r.readInt();
+    readKVPairs(r, entity.kv_pairs);
+    r.readBytes(14);
+    entity.position = readVector(r);
+    r.readBytes(4);
+    dbg(r.tell(), " Entity)\n");
 }
 
-void readObject(std::istream &s, Group &group);
+void readObject(RMFReader &r, Group &group);
 
-auto readGroup(std::istream &s, bool withheader = true)
+void readGroup(RMFReader &r, Group &group, bool withheader = true)
 {
-    dbg(s, " Group(\n");
-    Group group{};
+    dbg(r.tell(), " Group(\n");
     if (withheader)
     {
-        auto type = readNString(s);
-        rmfloadassert(
-            s,
-            type == "CMapGroup",
-            "expected CMapGroup, got '" + type + "'");
+        readType(r, "CMapGroup");
     }
-    group.visgroup_index = readInt(s);
-    group.color = readColor(s);
-    auto object_count = readInt(s);
-    for (int32_t i = 0; i < object_count; ++i)
+    group.visgroup_index = r.readInt();
+    group.color = readColor(r);
+    auto const object_count = r.readCount(MIN_OBJECT_SIZE);
+    for (size_t i = 0; i < object_count; ++i)
     {
-        readObject(s, group);
+        readObject(r, group);
     }
-    dbg(s, " Group)\n");
-    return group;
+    dbg(r.tell(), " Group)\n");
 }
 
-void readObject(std::istream &s, Group &group)
+void readObject(RMFReader &r, Group &group)
 {
-    auto type = readNString(s);
+    // Objects are read straight into their place in the group, so nested
+    // groups aren't copied on the way up.
+    auto const type = r.readNString();
     if (type == "CMapSolid")
     {
-        group.brushes.push_back(readSolid(s, false));
+        readSolid(r, group.brushes.emplace_back(), false);
     }
     else if (type == "CMapEntity")
     {
-        group.entities.push_back(readEntity(s, false));
+        readEntity(r, group.entities.emplace_back(), false);
     }
     else if (type == "CMapGroup")
     {
-        group.groups.push_back(readGroup(s, false));
+        readGroup(r, group.groups.emplace_back(), false);
     }
     else
     {
-        throw RMF::LoadError{s.tellg(), "Invalid Object type '" + type + "'"};
+        r.error("Invalid Object type '" + type + "'");
     }
 }
 
-auto readCorner(std::istream &s)
+Corner readCorner(RMFReader &r)
 {
-    dbg(s, " Corner(\n");
+    dbg(r.tell(), " Corner(\n");
     Corner corner{};
-    corner.position = readVector(s);
-    corner.index = readInt(s);
-    corner.name_override = readString(s, 128);
-    auto kv_pairs_count = readInt(s);
-    for (int32_t i = 0; i < kv_pairs_count; ++i)
-    {
-        auto key = readNString(s);
-        auto value = readNString(s);
-        corner.kv_pairs[key] = value;
-    }
-    dbg(s, " Corner)\n");
+    corner.position = readVector(r);
+    corner.index = r.readInt();
+    corner.name_override = r.readString(128);
+    readKVPairs(r, corner.kv_pairs);
+    dbg(r.tell(), " Corner)\n");
     return corner;
 }
 
-auto readPath(std::istream &s)
+Path readPath(RMFReader &r)
 {
-    dbg(s, " Path(\n");
+    dbg(r.tell(), " Path(\n");
     Path path{};
-    path.name = readString(s, 128);
-    path.class_ = readString(s, 128);
-    path.type = readInt(s);
-    auto corner_count = readInt(s);
-    for (int32_t i = 0; i < corner_count; ++i)
+    path.name = r.readString(128);
+    path.class_ = r.readString(128);
+    path.type = r.readInt();
+    auto const corner_count = r.readCount(MIN_VECTOR_SIZE + 4 + 128 + 4);
+    path.corners.reserve(corner_count);
+    for (size_t i = 0; i < corner_count; ++i)
     {
-        path.corners.push_back(readCorner(s));
+        path.corners.push_back(readCorner(r));
     }
-    dbg(s, " Path)\n");
+    dbg(r.tell(), " Path)\n");
     return path;
 }
 
-auto readCamera(std::istream &s)
+Camera readCamera(RMFReader &r)
 {
-    dbg(s, " Camera(\n");
+    dbg(r.tell(), " Camera(\n");
     Camera camera{};
-    camera.eye = readVector(s);
-    camera.look = readVector(s);
-    dbg(s, " Camera)\n");
+    camera.eye = readVector(r);
+    camera.look = readVector(r);
+    dbg(r.tell(), " Camera)\n");
     return camera;
 }
 
 RichMap RMF::load(std::string const &path)
+{
+    MappedFile file{};
+    try
+    {
+        file = MappedFile{path};
+    }
+    catch (std::runtime_error const &e)
+    {
+        throw LoadError{0, e.what()};
+    }
+    return parse(file.view());
+}
+
+RichMap RMF::parse(std::string_view data)
 {
 #if RMFENABLEDEBUG
     dbgstream.open("out.txt");
 #endif
 
-    std::ifstream s{path, std::ios::in | std::ios::binary};
-    s.exceptions(std::ios_base::failbit | std::ios_base::eofbit);
+    RMFReader r{data};
     RichMap map{};
 
-    map.version = readFloat(s);
+    map.version = r.readFloat();
     if (map.version != 2.2f)
     {
         std::cerr << "WARNING: Possibly unsupported RMF version " << map.version
                   << "!\n";
     }
 
-    char rmf[3];
-    s.read(rmf, 3);
-    rmfloadassert(
-        s,
-        rmf[0] == 'R' && rmf[1] == 'M' && rmf[2] == 'F',
-        "Missing RMF identifier");
+    auto const rmf = r.readString(3);
+    r.check(rmf == "RMF", "Missing RMF identifier");
 
-    auto visgroup_count = readInt(s);
-    for (int32_t i = 0; i < visgroup_count; ++i)
+    auto const visgroup_count = r.readCount(128 + 3 + 1 + 4 + 1 + 3);
+    map.visgroups.reserve(visgroup_count);
+    for (size_t i = 0; i < visgroup_count; ++i)
     {
-        map.visgroups.push_back(readVisGroup(s));
+        map.visgroups.push_back(readVisGroup(r));
     }
 
-    auto cmapworld = readNString(s);
-    rmfloadassert(
-        s,
-        cmapworld == "CMapWorld",
-        "Expected CMapWorld, got '" + cmapworld + "'");
-    readBytes(s, 7);
+    readType(r, "CMapWorld");
+    r.readBytes(7);
 
-    auto object_count = readInt(s);
-    for (int32_t i = 0; i < object_count; ++i)
+    auto const object_count = r.readCount(MIN_OBJECT_SIZE);
+    for (size_t i = 0; i < object_count; ++i)
     {
-        readObject(s, map.objects);
+        readObject(r, map.objects);
     }
 
-    map.worldspawn_name = readNString(s);
-    readBytes(s, 4);
+    map.worldspawn_name = r.readNString();
+    r.readBytes(4);
 
     [[maybe_unused]]
     auto worldspawn_flags
-        = readInt(s); // unused?
-    auto worldspawn_kv_count = readInt(s);
-    for (int32_t i = 0; i < worldspawn_kv_count; ++i)
+        = r.readInt(); // unused?
+    readKVPairs(r, map.worldspawn_properties);
+    r.readBytes(12);
+    auto const path_count = r.readCount(128 + 128 + 4 + 4);
+    map.paths.reserve(path_count);
+    for (size_t i = 0; i < path_count; ++i)
+    {
+        map.paths.push_back(readPath(r));
+    }
+    auto const docinfo = r.readString(8);
+    r.check(docinfo == "DOCINFO", "Expected DOCINFO, got '" + docinfo + "'");
+    r.readFloat();
+    map.active_camera = r.readInt();
+    auto const camera_count = r.readCount(2 * MIN_VECTOR_SIZE);
+    map.cameras.reserve(camera_count);
+    for (size_t i = 0; i < camera_count; ++i)
     {
-        auto key = readNString(s);
-        auto value = readNString(s);
-        map.worldspawn_properties[key] = value;
+        map.cameras.push_back(readCamera(r));
     }
-    readBytes(s, 12);
-    auto path_count = readInt(s);
-    for (int32_t i = 0; i < path_count; ++i)
+
+    return map;
+}
+
+/**
+ * Formats .rmf data into a buffer, which is written out to a stream in large
+ * blocks. Mirrors RMFReader.
+ */
+class RMFWriter
+{
+public:
+    /** Size the buffer grows to before being flushed. */
+    static constexpr size_t BLOCK_SIZE = 1 << 20;
+
+    explicit RMFWriter(std::ostream &out)
+    : _out{out}
     {
-        map.paths.push_back(readPath(s));
+        _buffer.reserve(BLOCK_SIZE + 1024);
     }
-    auto docinfo = readString(s, 8);
-    rmfloadassert(
-        s,
-        docinfo == "DOCINFO",
-        "Expected DOCINFO, got '" + docinfo + "'");
-    readFloat(s);
-    map.active_camera = readInt(s);
-    auto camera_count = readInt(s);
-    for (int32_t i = 0; i < camera_count; ++i)
+
+    ~RMFWriter() { flush(); }
+
+    RMFWriter(RMFWriter const &) = delete;
+    RMFWriter &operator=(RMFWriter const &) = delete;
+
+    void writeInt(int32_t i)
     {
-        map.cameras.push_back(readCamera(s));
+        auto const u = static_cast<uint32_t>(i);
+        char const b[4] = {
+            static_cast<char>(u & 0xff),
+            static_cast<char>((u >> 8) & 0xff),
+            static_cast<char>((u >> 16) & 0xff),
+            static_cast<char>((u >> 24) & 0xff)};
+        _append(b, 4);
     }
 
-    return map;
+    void writeFloat(float f)
+    {
+        char b[4];
+        std::memcpy(b, &f, 4);
+        _append(b, 4);
+    }
+
+    void writeByte(uint8_t b) { _append(reinterpret_cast<char *>(&b), 1); }
+
+    /** Write characters without a terminator or length. */
+    void writeChars(char const *chars, size_t n) { _append(chars, n); }
+
+    /** Write N zero bytes, for fields that aren't read. */
+    void writeBytes(size_t n)
+    {
+        _buffer.append(n, '\0');
+        _maybe_flush();
+    }
+
+    /** Write a fixed-size field holding a null-terminated string. */
+    void writeString(std::string const &str, size_t n)
+    {
+        _check_length(str, n - 1);
+        _append(str.data(), str.size());
+        writeBytes(n - str.size());
+    }
+
+    /** Write a length-prefixed, null-terminated string. */
+    void writeNString(std::string const &str)
+    {
+        _check_length(str, 254);
+        writeByte(static_cast<uint8_t>(str.size() + 1));
+        _append(str.c_str(), str.size() + 1);
+    }
+
+    /** Write a list count. */
+    void writeCount(size_t count)
+    {
+        if (count > INT32_MAX)
+        {
+            throw std::length_error{"too many items for .rmf"};
+        }
+        writeInt(static_cast<int32_t>(count));
+    }
+
+    void flush()
+    {
+        _out.write(
+            _buffer.data(),
+            static_cast<std::streamsize>(_buffer.size()));
+        _buffer.clear();
+    }
+
+private:
+    std::ostream &_out;
+    std::string _buffer{};
+
+    void _append(char const *data, size_t size)
+    {
+        _buffer.append(data, size);
+        _maybe_flush();
+    }
+
+    void _maybe_flush()
+    {
+        if (_buffer.size() >= BLOCK_SIZE)
+        {
+            flush();
+        }
+    }
+
+    static void _check_length(std::string const &str, size_t max)
+    {
+        if (str.size() > max)
+        {
+            throw std::length_error{"'" + str + "' is too long for .rmf"};
+        }
+    }
+};
+
+void writeColor(RMFWriter &w, Color const &color)
+{
+    w.writeByte(color.r);
+    w.writeByte(color.g);
+    w.writeByte(color.b);
+}
+
+void writeVisGroup(RMFWriter &w, VisGroup const &visgroup)
+{
+    w.writeString(visgroup.name, 128);
+    writeColor(w, visgroup.color);
+    w.writeBytes(1);
+    w.writeInt(visgroup.index);
+    w.writeByte(visgroup.visible ? 1 : 0);
+    w.writeBytes(3);
+}
+
+void writeVector(RMFWriter &w, Vector const &vector)
+{
+    w.writeFloat(vector.x);
+    w.writeFloat(vector.y);
+    w.writeFloat(vector.z);
+}
+
+void writeKVPairs(
+    RMFWriter &w,
+    std::unordered_map<std::string, std::string> const &kv_pairs)
+{
+    using KVPair = std::unordered_map<std::string, std::string>::value_type;
+    std::vector<KVPair const *> sorted{};
+    sorted.reserve(kv_pairs.size());
+    for (auto const &kv : kv_pairs)
+    {
+        sorted.push_back(&kv);
+    }
+    std::sort(
+        sorted.begin(),
+        sorted.end(),
+        [](auto const &a, auto const &b) { return a->first < b->first; });
+
+    w.writeCount(sorted.size());
+    for (auto const kv : sorted)
+    {
+        w.writeNString(kv->first);
+        w.writeNString(kv->second);
+    }
+}
+
+void writeFace(RMFWriter &w, Face const &face)
+{
+    w.writeString(face.texture_name, 256);
+    w.writeFloat(0.0f);
+    writeVector(w, face.texture_u);
+    w.writeFloat(face.texture_x_shift);
+    writeVector(w, face.texture_v);
+    w.writeFloat(face.texture_y_shift);
+    w.writeFloat(face.texture_rotation);
+    w.writeFloat(face.texture_x_scale);
+    w.writeFloat(face.texture_y_scale);
+    w.writeBytes(16);
+    w.writeCount(face.vertices.size());
+    for (auto const &vertex : face.vertices)
+    {
+        writeVector(w, vertex);
+    }
+    writeVector(w, face.plane[0]);
+    writeVector(w, face.plane[1]);
+    writeVector(w, face.plane[2]);
+}
+
+void writeSolid(RMFWriter &w, Solid const &solid)
+{
+    w.writeNString("CMapSolid");
+    w.writeInt(solid.visgroup_index);
+    writeColor(w, solid.color);
+    w.writeBytes(4);
+    w.writeCount(solid.faces.size());
+    for (auto const &face : solid.faces)
+    {
+        writeFace(w, face);
+    }
+}
+
+void writeEntity(RMFWriter &w, Entity const &entity)
+{
+    w.writeNString("CMapEntity");
+    w.writeInt(entity.visgroup_index);
+    writeColor(w, entity.color);
+    w.writeCount(entity.brushes.size());
+    for (auto const &brush : entity.brushes)
+    {
+        writeSolid(w, brush);
+    }
+    w.writeNString(entity.classname);
+    w.writeBytes(4);
+    w.writeInt(entity.flags);
+    writeKVPairs(w, entity.kv_pairs);
+    w.writeBytes(14);
+    writeVector(w, entity.position);
+    w.writeBytes(4);
+}
+
+/** Write the objects in a group, preceded by their count. */
+void writeObjects(RMFWriter &w, Group const &group)
+{
+    w.writeCount(
+        group.brushes.size() + group.entities.size() + group.groups.size());
+    for (auto const &brush : group.brushes)
+    {
+        writeSolid(w, brush);
+    }
+    for (auto const &entity : group.entities)
+    {
+        writeEntity(w, entity);
+    }
+    for (auto const &child : group.groups)
+    {
+        w.writeNString("CMapGroup");
+        w.writeInt(child.visgroup_index);
+        writeColor(w, child.color);
+        writeObjects(w, child);
+    }
+}
+
+void writeCorner(RMFWriter &w, Corner const &corner)
+{
+    writeVector(w, corner.position);
+    w.writeInt(corner.index);
+    w.writeString(corner.name_override, 128);
+    writeKVPairs(w, corner.kv_pairs);
+}
+
+void writePath(RMFWriter &w, Path const &path)
+{
+    w.writeString(path.name, 128);
+    w.writeString(path.class_, 128);
+    w.writeInt(path.type);
+    w.writeCount(path.corners.size());
+    for (auto const &corner : path.corners)
+    {
+        writeCorner(w, corner);
+    }
+}
+
+void writeCamera(RMFWriter &w, Camera const &camera)
+{
+    writeVector(w, camera.eye);
+    writeVector(w, camera.look);
+}
+
+void RMF::save(std::ostream &out, RichMap const &map)
+{
+    RMFWriter w{out};
+
+    w.writeFloat(map.version);
+    w.writeChars("RMF", 3);
+    w.writeCount(map.visgroups.size());
+    for (auto const &visgroup : map.visgroups)
+    {
+        writeVisGroup(w, visgroup);
+    }
+
+    w.writeNString("CMapWorld");
+    w.writeBytes(7);
+    writeObjects(w, map.objects);
+
+    w.writeNString(map.worldspawn_name);
+    w.writeBytes(4);
+    w.writeInt(0);
+    writeKVPairs(w, map.worldspawn_properties);
+    w.writeBytes(12);
+    w.writeCount(map.paths.size());
+    for (auto const &path : map.paths)
+    {
+        writePath(w, path);
+    }
+
+    w.writeString("DOCINFO", 8);
+    w.writeFloat(0.2f);
+    w.writeInt(map.active_camera);
+    w.writeCount(map.cameras.size());
+    for (auto const &camera : map.cameras)
+    {
+        writeCamera(w, camera);
+    }
 }
@@ -1,6 +1,6 @@
 /**
  * rmf.hpp - Rich Map Format data.
- * Copyright (C) 2023 Trevor Last
+ * Copyright (C) 2023-2024 Trevor Last
  *
  *  This program is free software: you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -22,6 +22,7 @@
 #include <iosfwd>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -134,7 +135,30 @@ namespace RMF
         std::vector<Camera> cameras{};
     };
 
+    /**
+     * Load a .rmf file. The file is mapped into memory and parsed with
+     * parse().
+     *
+     * @throw LoadError if the file can't be read or isn't a valid .rmf.
+     */
     RichMap load(std::string const &path);
+
+    /**
+     * Parse the contents of a .rmf file.
+     *
+     * @throw LoadError if DATA isn't a valid .rmf.
+     */
+    RichMap parse(std::string_view data);
+
+    /**
+     * Save a map in .rmf format. Objects in each group are written in the
+     * order brushes, entities, groups, and key/value pairs are sorted by
+     * key.
+     *
+     * @throw std::length_error if a string is too long to be stored in the
+     *                          .rmf format.
+     */
+    void save(std::ostream &out, RichMap const &map);
 } // namespace RMF
 
 #endif
@@ -18,6 +18,8 @@
 
 #include "LumpTexture.hpp"
 
+#include <cstring>
+
 using namespace WAD;
 
 static uint32_t u32_correct_endian(uint8_t const bytes[4])
@@ -33,52 +35,27 @@ static uint16_t u16_correct_endian(uint8_t const bytes[2])
     return integer;
 }
 
-LumpTexture::LumpTexture(
-    WADReader::DirectoryEntry const &entry,
-    uint8_t const *bytes)
-: _name{entry.name}
+LumpTexture::LumpTexture(LumpTextureView const &view)
+: _name{view.name()}
+, _texture_name{view.texture_name()}
+, _width{view.width()}
+, _height{view.height()}
 {
-    if (entry.type != 0x43)
-    {
-        throw BadTypeException{"expected lump type 0x43"};
-    }
-
-    // TODO: Would be good to have some bounds safety here instead of just
-    // trusting the pointer.
-    _texture_name = std::string{bytes, bytes + 16};
-
-    _width = u32_correct_endian(bytes + 16);
-    _height = u32_correct_endian(bytes + 20);
-
-    // Load textures.
     for (decltype(_textures)::size_type i = 0; i < _textures.size(); ++i)
     {
-        auto const tex_offset = u32_correct_endian(bytes + 24 + 4 * i);
-        auto const tex_ptr = bytes + tex_offset;
-
+        auto const tex_ptr = view.mipmap(i);
         auto const width = _width / (1 << i);
         auto const height = _height / (1 << i);
-
-        auto &texdata = _textures.at(i);
-        texdata.insert(texdata.end(), tex_ptr, tex_ptr + width * height);
+        _textures.at(i).assign(tex_ptr, tex_ptr + width * height);
     }
 
-    // Load palette.
-    auto const final_tex_offset
-        = u32_correct_endian(bytes + 24 + 4 * (_textures.size() - 1));
-    auto const final_width = _width / (1 << (_textures.size() - 1));
-    auto const final_height = _height / (1 << (_textures.size() - 1));
-
-    auto const palette_offset = final_tex_offset + final_width * final_height;
-    auto const palette_ptr = bytes + palette_offset;
-
-    auto const palette_size = u16_correct_endian(palette_ptr);
-    for (uint16_t i = 0; i < palette_size; ++i)
+    auto const palette_ptr = view.palette();
+    for (size_t i = 0; i < view.palette_size(); ++i)
     {
         _palette.push_back(
-            {(palette_ptr + 2 + 3 * i)[0],
-             (palette_ptr + 2 + 3 * i)[1],
-             (palette_ptr + 2 + 3 * i)[2]});
+            {palette_ptr[3 * i + 0],
+             palette_ptr[3 * i + 1],
+             palette_ptr[3 * i + 2]});
     }
 }
 
@@ -126,3 +103,92 @@ std::vector<std::array<uint8_t, 3>> const &LumpTexture::palette() const
 {
     return _palette;
 }
+
+LumpTextureView::LumpTextureView(
+    WADReader::DirectoryEntry const &entry,
+    std::shared_ptr<uint8_t const> const &bytes)
+: _bytes{bytes}
+, _name{entry.name, strnlen(entry.name, sizeof(entry.name))}
+{
+    if (entry.type != 0x43)
+    {
+        throw LumpTexture::BadTypeException{"expected lump type 0x43"};
+    }
+
+    // Name, width, height and the four mipmap offsets.
+    constexpr size_t HEADER_SIZE = 16 + 4 + 4 + 4 * 4;
+    size_t const size = entry.dsize;
+    auto const ptr = _bytes.get();
+    if (size < HEADER_SIZE)
+    {
+        throw LumpTexture::BadLumpException{"texture lump is too small"};
+    }
+
+    _width = u32_correct_endian(ptr + 16);
+    _height = u32_correct_endian(ptr + 20);
+
+    // The palette follows the last mipmap.
+    size_t end = HEADER_SIZE;
+    for (decltype(_mipmaps)::size_type i = 0; i < _mipmaps.size(); ++i)
+    {
+        size_t const tex_offset = u32_correct_endian(ptr + 24 + 4 * i);
+        size_t const tex_size = size_t{_width >> i} * (_height >> i);
+        if (tex_offset > size || tex_size > size - tex_offset)
+        {
+            throw LumpTexture::BadLumpException{"mipmap is out of bounds"};
+        }
+        _mipmaps.at(i) = ptr + tex_offset;
+        end = tex_offset + tex_size;
+    }
+
+    if (end + 2 > size)
+    {
+        throw LumpTexture::BadLumpException{"palette is out of bounds"};
+    }
+    _palette_size = u16_correct_endian(ptr + end);
+    _palette = ptr + end + 2;
+    if (3 * _palette_size > size - end - 2)
+    {
+        throw LumpTexture::BadLumpException{"palette is out of bounds"};
+    }
+}
+
+std::string LumpTextureView::name() const
+{
+    return _name;
+}
+
+std::string LumpTextureView::texture_name() const
+{
+    if (!_bytes)
+    {
+        return {};
+    }
+    auto const ptr = reinterpret_cast<char const *>(_bytes.get());
+    return std::string{ptr, ptr + 16};
+}
+
+uint32_t LumpTextureView::width() const
+{
+    return _width;
+}
+
+uint32_t LumpTextureView::height() const
+{
+    return _height;
+}
+
+uint8_t const *LumpTextureView::mipmap(size_t level) const
+{
+    return _mipmaps.at(level);
+}
+
+uint8_t const *LumpTextureView::palette() const
+{
+    return _palette;
+}
+
+size_t LumpTextureView::palette_size() const
+{
+    return _palette_size;
+}
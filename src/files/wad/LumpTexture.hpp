@@ -22,13 +22,17 @@
 #include "WADReader.hpp"
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
 namespace WAD
 {
+    class LumpTextureView;
+
     /**
      * Texture lump. Type 0x43.
      */
@@ -46,8 +50,26 @@ namespace WAD
             }
         };
 
+        /**
+         * Thrown if a lump's offsets or sizes point outside of the lump.
+         */
+        struct BadLumpException : std::runtime_error
+        {
+            BadLumpException(std::string const &what)
+            : std::runtime_error{what}
+            {
+            }
+        };
+
         LumpTexture() = default;
 
+        /**
+         * Copy a texture lump's data out of a view.
+         *
+         * @param view The lump to copy.
+         */
+        explicit LumpTexture(LumpTextureView const &view);
+
         /** Name of the lump in the directory. */
         std::string name() const;
 
@@ -75,20 +97,72 @@ namespace WAD
         /** RGB triples comprising the palette. */
         std::vector<std::array<uint8_t, 3>> const &palette() const;
 
+    private:
+        std::string _name{};
+        std::string _texture_name{};
+        uint32_t _width{0}, _height{0};
+
+        std::array<std::vector<uint8_t>, 4> _textures{};
+        std::vector<std::array<uint8_t, 3>> _palette{};
+    };
+
+    /**
+     * Texture lump which doesn't own a copy of its data. The mipmaps and
+     * palette point straight into the lump's bytes, which are usually part
+     * of a memory-mapped WAD. The bytes stay alive as long as the view does.
+     */
+    class LumpTextureView
+    {
+    public:
+        LumpTextureView() = default;
+
+        /** Name of the lump in the directory. */
+        std::string name() const;
+
+        /** Internal name of the texture. */
+        std::string texture_name() const;
+
+        /** Width of full size texture in pixels. */
+        uint32_t width() const;
+
+        /** Height of full size texture in pixels. */
+        uint32_t height() const;
+
+        /**
+         * Pixels making up a mipmap, one palette index per pixel.
+         *
+         * @param level 0 for the full size texture, up to 3 for eighth size.
+         * @return (width >> level) * (height >> level) palette indices.
+         */
+        uint8_t const *mipmap(size_t level) const;
+
+        /** RGB triples comprising the palette. */
+        uint8_t const *palette() const;
+
+        /** Number of colours in the palette. */
+        size_t palette_size() const;
+
     protected:
         friend class WADReader;
 
-        LumpTexture(
+        /**
+         * @param entry Directory entry for the lump.
+         * @param bytes The lump's bytes, entry.dsize long.
+         * @throw LumpTexture::BadTypeException if lump is not a texture lump.
+         * @throw LumpTexture::BadLumpException if lump data is out of bounds.
+         */
+        LumpTextureView(
             WADReader::DirectoryEntry const &entry,
-            uint8_t const *bytes);
+            std::shared_ptr<uint8_t const> const &bytes);
 
     private:
+        std::shared_ptr<uint8_t const> _bytes{};
         std::string _name{};
-        std::string _texture_name{};
-        uint32_t _width, _height;
+        uint32_t _width{0}, _height{0};
 
-        std::array<std::vector<uint8_t>, 4> _textures{};
-        std::vector<std::array<uint8_t, 3>> _palette{};
+        std::array<uint8_t const *, 4> _mipmaps{};
+        uint8_t const *_palette{nullptr};
+        size_t _palette_size{0};
     };
 } // namespace WAD
 
@@ -0,0 +1,195 @@
+/**
+ * Palette.cpp - Palette expansion.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Palette.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SE_WAD_X86 1
+#include <immintrin.h>
+#else
+#define SE_WAD_X86 0
+#endif
+
+/**
+ * Every palette is widened to 256 RGBA entries first, so each pixel is a
+ * single 4 byte load, whatever its index.
+ */
+struct Table
+{
+    alignas(32) uint8_t rgba[256][4];
+};
+
+using Kernel = void (*)(uint8_t const *, size_t, Table const &, uint8_t *);
+
+static Table make_table(uint8_t const *palette, size_t palette_size)
+{
+    Table table{};
+    auto const count = std::min<size_t>(palette_size, 256);
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::copy_n(palette + 3 * i, 3, table.rgba[i]);
+    }
+    for (auto &entry : table.rgba)
+    {
+        entry[3] = 0xff;
+    }
+    return table;
+}
+
+/* ===[ Kernels ]=== */
+static void rgba_scalar(
+    uint8_t const *indices,
+    size_t count,
+    Table const &table,
+    uint8_t *out)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::memcpy(out + 4 * i, table.rgba[indices[i]], 4);
+    }
+}
+
+static void rgb_scalar(
+    uint8_t const *indices,
+    size_t count,
+    Table const &table,
+    uint8_t *out)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    // Copying 4 bytes is quicker than 3. The extra byte is overwritten by
+    // the next pixel, except for the last one.
+    for (size_t i = 0; i + 1 < count; ++i)
+    {
+        std::memcpy(out + 3 * i, table.rgba[indices[i]], 4);
+    }
+    std::memcpy(out + 3 * (count - 1), table.rgba[indices[count - 1]], 3);
+}
+
+#if SE_WAD_X86
+/** Look up 8 pixels at once. */
+__attribute__((target("avx2"))) static __m256i gather8(
+    uint8_t const *indices,
+    Table const &table)
+{
+    auto const bytes
+        = _mm_loadl_epi64(reinterpret_cast<__m128i const *>(indices));
+    auto const offsets = _mm256_cvtepu8_epi32(bytes);
+    return _mm256_i32gather_epi32(
+        reinterpret_cast<int const *>(table.rgba),
+        offsets,
+        4);
+}
+
+__attribute__((target("avx2"))) static void rgba_avx2(
+    uint8_t const *indices,
+    size_t count,
+    Table const &table,
+    uint8_t *out)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i *>(out + 4 * i),
+            gather8(indices + i, table));
+    }
+    rgba_scalar(indices + i, count - i, table, out + 4 * i);
+}
+
+__attribute__((target("avx2"))) static void rgb_avx2(
+    uint8_t const *indices,
+    size_t count,
+    Table const &table,
+    uint8_t *out)
+{
+    // Drop every fourth byte, packing each lane's 4 pixels into its low 12
+    // bytes.
+    auto const pack = _mm256_setr_epi8(
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+    // Each lane is stored as 16 bytes, 4 past the 12 wanted, so the last
+    // few pixels are left to the scalar loop.
+    size_t i = 0;
+    for (; i + 10 <= count; i += 8)
+    {
+        auto const pixels
+            = _mm256_shuffle_epi8(gather8(indices + i, table), pack);
+        auto const dst = out + 3 * i;
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(dst),
+            _mm256_castsi256_si128(pixels));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(dst + 12),
+            _mm256_extracti128_si256(pixels, 1));
+    }
+    rgb_scalar(indices + i, count - i, table, out + 3 * i);
+}
+#endif // SE_WAD_X86
+
+struct Kernels
+{
+    Kernel rgba;
+    Kernel rgb;
+};
+
+/** Pick the widest kernels the CPU supports. Only checked once. */
+static Kernels const &get_kernels()
+{
+    static Kernels const kernels = []() -> Kernels
+    {
+#if SE_WAD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return {rgba_avx2, rgb_avx2};
+        }
+#endif
+        return {rgba_scalar, rgb_scalar};
+    }();
+    return kernels;
+}
+
+/* ===[ Public ]=== */
+void WAD::palette_to_rgba(
+    uint8_t const *indices,
+    size_t count,
+    uint8_t const *palette,
+    size_t palette_size,
+    uint8_t *out)
+{
+    auto const table = make_table(palette, palette_size);
+    get_kernels().rgba(indices, count, table, out);
+}
+
+void WAD::palette_to_rgb(
+    uint8_t const *indices,
+    size_t count,
+    uint8_t const *palette,
+    size_t palette_size,
+    uint8_t *out)
+{
+    auto const table = make_table(palette, palette_size);
+    get_kernels().rgb(indices, count, table, out);
+}
@@ -0,0 +1,66 @@
+/**
+ * Palette.hpp - Palette expansion.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_FILES_WAD_PALETTE_HPP
+#define SE_FILES_WAD_PALETTE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace WAD
+{
+    /**
+     * Expand palette indices to RGBA pixels, with alpha always 0xff. Uses
+     * SIMD where the CPU supports it.
+     *
+     * Indices past the end of the palette come out black.
+     *
+     * @param indices Palette index of each pixel.
+     * @param count Number of pixels.
+     * @param palette RGB triples.
+     * @param palette_size Number of colours in the palette.
+     * @param out Buffer at least 4 * COUNT bytes long.
+     */
+    void palette_to_rgba(
+        uint8_t const *indices,
+        size_t count,
+        uint8_t const *palette,
+        size_t palette_size,
+        uint8_t *out);
+
+    /**
+     * Expand palette indices to RGB pixels. Uses SIMD where the CPU supports
+     * it.
+     *
+     * Indices past the end of the palette come out black.
+     *
+     * @param indices Palette index of each pixel.
+     * @param count Number of pixels.
+     * @param palette RGB triples.
+     * @param palette_size Number of colours in the palette.
+     * @param out Buffer at least 3 * COUNT bytes long.
+     */
+    void palette_to_rgb(
+        uint8_t const *indices,
+        size_t count,
+        uint8_t const *palette,
+        size_t palette_size,
+        uint8_t *out);
+} // namespace WAD
+
+#endif
@@ -21,6 +21,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 
 namespace WAD
 {
@@ -29,6 +30,8 @@ namespace WAD
      */
     struct WADInputStream
     {
+        virtual ~WADInputStream() = default;
+
         /**
          * Seek the input stream to offset.
          *
@@ -58,6 +61,29 @@ namespace WAD
          * @note WAD format is little-endian, this method returns host-endian.
          */
         virtual uint32_t read_uint32() = 0;
+
+        /**
+         * Get direct access to count bytes starting at offset, without
+         * copying them. Streams which can't do this return nullptr, and
+         * callers should fall back to read_bytes().
+         *
+         * @param offset Position of the first byte.
+         * @param count Number of bytes needed.
+         * @return Pointer to the bytes, which keeps them alive, or nullptr.
+         */
+        virtual std::shared_ptr<uint8_t const> map(size_t offset, size_t count)
+        {
+            return nullptr;
+        }
+
+        /**
+         * Hint that bytes returned by map() won't be needed again soon, so
+         * their memory can be given back. They stay valid to read.
+         *
+         * @param offset Position of the first byte.
+         * @param count Number of bytes.
+         */
+        virtual void release(size_t offset, size_t count) {}
     };
 } // namespace WAD
 
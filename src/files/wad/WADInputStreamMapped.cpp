@@ -0,0 +1,84 @@
+/**
+ * WADInputStreamMapped.cpp - Memory-mapped WAD input stream.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "WADInputStreamMapped.hpp"
+
+#include <utils/MappedFile.hpp>
+
+#include <stdexcept>
+
+using namespace WAD;
+
+WADInputStreamMapped::WADInputStreamMapped(std::string const &path)
+: _file{std::make_shared<MappedFile const>(path, MappedFile::Access::RANDOM)}
+, _stream{}
+{
+    // Reads are small and scattered, a large buffer only wastes time.
+    _stream.rdbuf()->pubsetbuf(_buffer, sizeof(_buffer));
+    _stream.exceptions(std::ios::failbit | std::ios::badbit);
+    _stream.open(path, std::ios::binary);
+}
+
+void WADInputStreamMapped::seek(size_t offset)
+{
+    // A failed read leaves the stream in a failed state. Every read starts
+    // with a seek, so clearing it here stops one bad lump failing the rest.
+    _stream.clear();
+    _stream.seekg(offset);
+}
+
+void WADInputStreamMapped::read_bytes(void *buf, size_t count)
+{
+    _stream.read(static_cast<char *>(buf), count);
+}
+
+uint8_t WADInputStreamMapped::read_uint8()
+{
+    uint8_t byte = 0;
+    read_bytes(&byte, 1);
+    return byte;
+}
+
+uint32_t WADInputStreamMapped::read_uint32()
+{
+    uint8_t raw[4];
+    read_bytes(raw, 4);
+    return raw[0] | (raw[1] << 8) | (raw[2] << 16) | (raw[3] << 24);
+}
+
+std::shared_ptr<uint8_t const> WADInputStreamMapped::map(
+    size_t offset,
+    size_t count)
+{
+    // Share ownership of the mapping, but point at the requested bytes.
+    return {_file, _take(offset, count)};
+}
+
+void WADInputStreamMapped::release(size_t offset, size_t count)
+{
+    _file->discard(offset, count);
+}
+
+uint8_t const *WADInputStreamMapped::_take(size_t offset, size_t count) const
+{
+    if (offset > _file->size() || count > _file->size() - offset)
+    {
+        throw std::out_of_range{"read past the end of the WAD"};
+    }
+    return reinterpret_cast<uint8_t const *>(_file->data()) + offset;
+}
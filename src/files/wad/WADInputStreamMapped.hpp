@@ -0,0 +1,72 @@
+/**
+ * WADInputStreamMapped.hpp - Memory-mapped WAD input stream.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_FILES_WAD_WADINPUTSTREAMMAPPED_HPP
+#define SE_FILES_WAD_WADINPUTSTREAMMAPPED_HPP
+
+#include "WADInputStream.hpp"
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+class MappedFile;
+
+namespace WAD
+{
+    /**
+     * Reads a WAD from a memory-mapped file. Lumps can be mapped without
+     * copying them, and the file stays mapped while any mapped lump is still
+     * in use.
+     *
+     * Reads that aren't mapped, like the directory and lump headers, go
+     * through an ordinary file stream. Reading them from the mapping would
+     * page in the neighbouring lump data too.
+     */
+    class WADInputStreamMapped : public WADInputStream
+    {
+    public:
+        /**
+         * Map the WAD at path.
+         *
+         * @param path Path to the WAD.
+         * @throw std::runtime_error if the file can't be opened or mapped.
+         */
+        explicit WADInputStreamMapped(std::string const &path);
+
+        // WADInputStream interface. Reading past the end of the file throws
+        // std::ios_base::failure, mapping past it throws std::out_of_range.
+        virtual void seek(size_t offset) override;
+        virtual void read_bytes(void *buf, size_t count) override;
+        virtual uint8_t read_uint8() override;
+        virtual uint32_t read_uint32() override;
+        virtual std::shared_ptr<uint8_t const> map(
+            size_t offset,
+            size_t count) override;
+        virtual void release(size_t offset, size_t count) override;
+
+    private:
+        std::shared_ptr<MappedFile const> _file;
+        char _buffer[256];
+        std::ifstream _stream;
+
+        uint8_t const *_take(size_t offset, size_t count) const;
+    };
+} // namespace WAD
+
+#endif
@@ -18,6 +18,8 @@
 
 #include "WADReader.hpp"
 
+#include <cstring>
+
 using namespace WAD;
 
 WADReader::WADReader(WADInputStream &inputstream)
@@ -48,12 +50,43 @@ void WADReader::load()
 
 LumpTexture WADReader::load_lump_texture(DirectoryEntry const &entry)
 {
-    _stream.seek(entry.lump_offset);
-    unsigned char bytes[entry.dsize];
-    _stream.read_bytes(bytes, entry.dsize);
+    return LumpTexture{load_lump_texture_view(entry)};
+}
+
+LumpTextureView WADReader::load_lump_texture_view(DirectoryEntry const &entry)
+{
+    if (entry.type != 0x43)
+    {
+        throw LumpTexture::BadTypeException{"expected lump type 0x43"};
+    }
+
+    auto bytes = _stream.map(entry.lump_offset, entry.dsize);
+    if (!bytes)
+    {
+        std::shared_ptr<uint8_t[]> buffer{new uint8_t[entry.dsize]};
+        _stream.seek(entry.lump_offset);
+        _stream.read_bytes(buffer.get(), entry.dsize);
+        bytes = std::shared_ptr<uint8_t const>{buffer, buffer.get()};
+    }
+    return LumpTextureView{entry, bytes};
+}
+
+WADReader::TextureHeader WADReader::load_texture_header(
+    DirectoryEntry const &entry)
+{
+    if (entry.type != 0x43)
+    {
+        throw LumpTexture::BadTypeException{"expected lump type 0x43"};
+    }
 
-    LumpTexture texlump{entry, bytes};
-    return texlump;
+    // Skip the lump's internal name, only the directory name is used.
+    _stream.seek(entry.lump_offset + 16);
+
+    TextureHeader header{};
+    header.name = std::string{entry.name, strnlen(entry.name, 16)};
+    header.width = _stream.read_uint32();
+    header.height = _stream.read_uint32();
+    return header;
 }
 
 WADReader::Header WADReader::read_header()
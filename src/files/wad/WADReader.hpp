@@ -23,11 +23,13 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <string>
 #include <vector>
 
 namespace WAD
 {
     class LumpTexture;
+    class LumpTextureView;
 
     /**
      * Extracts data from a .wad file.
@@ -45,6 +47,14 @@ namespace WAD
             char name[16];
         };
 
+        /** The parts of a texture lump needed to index it. */
+        struct TextureHeader
+        {
+            std::string name;
+            uint32_t width;
+            uint32_t height;
+        };
+
         WADReader(WADInputStream &inputstream);
 
         /**
@@ -72,10 +82,36 @@ namespace WAD
          *
          * @param entry Directory entry for the lump.
          * @return The loaded texture lump.
-         * @throw WAD::TexLumpLoadError if lump is not a texture lump.
+         * @throw WAD::LumpTexture::BadTypeException if lump is not a texture
+         *        lump.
+         * @throw WAD::LumpTexture::BadLumpException if the lump is corrupt.
          */
         LumpTexture load_lump_texture(DirectoryEntry const &entry);
 
+        /**
+         * Load a texture lump without copying its data, if the input stream
+         * supports mapping. Otherwise the lump is read into a buffer owned
+         * by the view.
+         *
+         * @param entry Directory entry for the lump.
+         * @return A view of the texture lump.
+         * @throw WAD::LumpTexture::BadTypeException if lump is not a texture
+         *        lump.
+         * @throw WAD::LumpTexture::BadLumpException if the lump is corrupt.
+         */
+        LumpTextureView load_lump_texture_view(DirectoryEntry const &entry);
+
+        /**
+         * Load only the header of a texture lump. This is much cheaper than
+         * load_lump_texture(), as none of the pixel data is read.
+         *
+         * @param entry Directory entry for the lump.
+         * @return The texture's name and size.
+         * @throw WAD::LumpTexture::BadTypeException if lump is not a texture
+         *        lump.
+         */
+        TextureHeader load_texture_header(DirectoryEntry const &entry);
+
     protected:
         static constexpr size_t HEADER_SIZE = 12;
         static constexpr size_t DIRECTORY_ENTRY_SIZE = 32;
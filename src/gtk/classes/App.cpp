@@ -22,11 +22,16 @@
 #include <config/appid.hpp>
 #include <editor/core/gamedefinition/GameDefinition.hpp>
 #include <editor/textures/TextureManager.hpp>
+#include <utils/Filesystem.hpp>
 #include <world3d/Entity.hpp>
+#include <world3d/Texture.hpp>
 
 #include <gtkmm/filechoosernative.h>
 #include <gtkmm/messagedialog.h>
 
+#include <algorithm>
+#include <filesystem>
+
 Glib::RefPtr<Sickle::App> Sickle::App::create()
 {
     return Glib::RefPtr{new App{}};
@@ -55,6 +60,16 @@ Sickle::App::App()
     _settings->bind("game-root-path", property_game_root_path());
     _settings->bind("sprite-root-path", property_sprite_root_path());
     _settings->bind("wad-paths", property_wad_paths());
+
+    _settings->signal_changed("texture-memory-budget")
+        .connect(sigc::hide(
+            sigc::mem_fun(*this, &App::_on_texture_memory_budget_changed)));
+    _on_texture_memory_budget_changed();
+
+    _settings->signal_changed("gpu-texture-memory-budget")
+        .connect(sigc::hide(
+            sigc::mem_fun(*this, &App::_on_gpu_texture_memory_budget_changed)));
+    _on_gpu_texture_memory_budget_changed();
 }
 
 void Sickle::App::on_startup()
@@ -167,17 +182,28 @@ void Sickle::App::on_action_save()
     chooser->add_filter(map_filter);
     chooser->set_filter(map_filter);
 
+    auto rmf_filter = Gtk::FileFilter::create();
+    rmf_filter->add_pattern("*.rmf");
+    rmf_filter->set_name("Hammer/Worldcraft Maps");
+    chooser->add_filter(rmf_filter);
+
     int const response = chooser->run();
 
     auto filename = chooser->get_filename();
     if (chooser->get_filter() == map_filter)
     {
-        auto const x = filename.rfind(".map");
-        if (x == std::string::npos)
+        if (!has_extension(filename, ".map"))
         {
             filename.append(".map");
         }
     }
+    else if (chooser->get_filter() == rmf_filter)
+    {
+        if (!has_extension(filename, ".rmf"))
+        {
+            filename.append(".rmf");
+        }
+    }
 
     if (response == Gtk::ResponseType::RESPONSE_ACCEPT)
     {
@@ -253,11 +279,8 @@ void Sickle::App::_sync_wadpaths()
         }
     }
 
-    // Add new WADs.
-    for (auto const &path : paths)
-    {
-        texman.add_wad(path);
-    }
+    // Add new WADs. They're read in parallel.
+    texman.add_wads({paths.cbegin(), paths.cend()});
 }
 
 void Sickle::App::_on_hide_window(Gtk::Window *window)
@@ -293,3 +316,17 @@ void Sickle::App::_on_wad_paths_changed()
 {
     _sync_wadpaths();
 }
+
+void Sickle::App::_on_texture_memory_budget_changed()
+{
+    auto &texman = Sickle::Editor::Textures::TextureManager::get_reference();
+    auto const mib = _settings->get_uint("texture-memory-budget");
+    texman.set_memory_budget(static_cast<size_t>(mib) * 1024 * 1024);
+}
+
+void Sickle::App::_on_gpu_texture_memory_budget_changed()
+{
+    auto const mib = _settings->get_uint("gpu-texture-memory-budget");
+    auto &budget = World3D::Texture::budget();
+    budget.set_budget(static_cast<size_t>(mib) * 1024 * 1024);
+}
@@ -91,6 +91,8 @@ namespace Sickle
         void _on_game_root_path_changed();
         void _on_sprite_root_path_changed();
         void _on_wad_paths_changed();
+        void _on_texture_memory_budget_changed();
+        void _on_gpu_texture_memory_budget_changed();
     };
 } // namespace Sickle
 
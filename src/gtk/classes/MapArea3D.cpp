@@ -23,6 +23,7 @@
 #include <world3d/raycast/Collider.hpp>
 #include <world3d/raycast/ColliderFactory.hpp>
 #include <world3d/RenderComponentFactory.hpp>
+#include <world3d/Texture.hpp>
 
 #include <iostream>
 
@@ -343,6 +344,9 @@ bool Sickle::MapArea3D::on_render(Glib::RefPtr<Gdk::GLContext> const &context)
     // Let deferred functions run.
     DeferredExec::context_ready();
 
+    // Evict textures left over budget by changes made without a context.
+    World3D::Texture::budget().trim();
+
     // Draw the world.
     // Walk the world tree and execute any World3D render components.
     // Note that the traversal must be done in depth-first ordering, to allow
@@ -498,6 +502,11 @@ void Sickle::MapArea3D::_synchronize_glmap()
     static auto const add_entity = [](Editor::EditorObjectRef child) -> void
     {
         auto const entity = Editor::EntityRef::cast_dynamic(child);
+        if (!entity)
+        {
+            // Groups are drawn through their members.
+            return;
+        }
         entity->add_component(
             World3D::RenderComponentFactory{}.construct(entity));
         entity->add_component(World3D::ColliderFactory{}.construct(entity));
@@ -24,36 +24,31 @@
 #include <config/appid.hpp>
 #include <config/version.hpp>
 #include <editor/operations/Operation.hpp>
-#include <files/map/mapsaver.hpp>
+#include <editor/world/WorldCache.hpp>
 #include <files/rmf/rmf.hpp>
 #include <se-lua/function.hpp>
 #include <se-lua/lua-geo/LuaGeo.hpp>
 #include <se-lua/se-lua.hpp>
+#include <utils/Filesystem.hpp>
 
 #include <giomm/resource.h>
 #include <glibmm/fileutils.h>
+#include <glibmm/main.h>
+#include <glibmm/miscutils.h>
 #include <gtkmm/builder.h>
 #include <gtkmm/messagedialog.h>
 #include <gtkmm/settings.h>
 
 #include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <typeinfo>
 
 using namespace Sickle::AppWin;
 
-/** Convert a string to lowercase. */
-std::string lowercase(std::string s)
-{
-    std::transform(
-        s.begin(),
-        s.end(),
-        s.begin(),
-        [](unsigned char ch) { return std::tolower(ch); });
-    return s;
-}
-
 /**
  * Thrown by 'loadAnyMapFile' if neither RMF or MAP format can load the file
  * correctly.
@@ -125,6 +120,7 @@ AppWin::AppWin()
               to = from / 2;
               return true;
           }})}
+, _settings{Gio::Settings::create(SE_APPLICATION_ID)}
 {
     set_show_menubar(true);
     set_icon(Gdk::Pixbuf::create_from_resource(SE_GRESOURCE_PREFIX "logo.png"));
@@ -251,12 +247,16 @@ AppWin::AppWin()
         });
     property_grid_size().signal_changed().connect(
         sigc::mem_fun(*this, &AppWin::_on_grid_size_changed));
+    _settings->signal_changed("autosave-interval")
+        .connect(sigc::hide(
+            sigc::mem_fun(*this, &AppWin::_on_autosave_interval_changed)));
 
     _opsearch->set_transient_for(*this);
     _opsearch->signal_operation_chosen().connect(
         sigc::mem_fun(*this, &AppWin::_on_opsearch_op_chosen));
 
     _on_grid_size_changed();
+    _on_autosave_interval_changed();
 
     if (!L)
     {
@@ -271,18 +271,18 @@ AppWin::AppWin()
     _luainfobar.hide();
 }
 
-Glib::RefPtr<Sickle::Editor::World> loadAnyMapFile(
+Glib::RefPtr<Sickle::Editor::World> loadAnyMapFileUncached(
     Glib::RefPtr<Gio::File> const &file)
 {
     auto const path = file->get_path();
-    if (lowercase(path).rfind(".rmf") != std::string::npos)
+    if (has_extension(path, ".rmf"))
     {
         return Sickle::Editor::World::create(RMF::load(path));
     }
 
-    else if (lowercase(path).rfind(".map") != std::string::npos)
+    else if (has_extension(path, ".map"))
     {
-        return Sickle::Editor::World::create(MAP::load(path));
+        return Sickle::Editor::World::load_map(path);
     }
 
     std::string rmferror{};
@@ -297,7 +297,7 @@ Glib::RefPtr<Sickle::Editor::World> loadAnyMapFile(
     }
     try
     {
-        return Sickle::Editor::World::create(MAP::load(file->get_path()));
+        return Sickle::Editor::World::load_map(file->get_path());
     }
     catch (MAP::LoadError const &e)
     {
@@ -306,6 +306,24 @@ Glib::RefPtr<Sickle::Editor::World> loadAnyMapFile(
     throw GenericLoadError{rmferror, maperror};
 }
 
+/**
+ * Load a map file through the world cache. On a cache miss, the cache is
+ * written in the background, and CACHE_WRITE is set to track it.
+ */
+Glib::RefPtr<Sickle::Editor::World> loadAnyMapFile(
+    Glib::RefPtr<Gio::File> const &file,
+    std::future<void> &cache_write)
+{
+    Sickle::Editor::WorldCache const cache{file->get_path()};
+    if (auto const world = cache.load())
+    {
+        return world;
+    }
+    auto const world = loadAnyMapFileUncached(file);
+    cache_write = cache.save(world);
+    return world;
+}
+
 void AppWin::open(Glib::RefPtr<Gio::File> const &file)
 {
     if (file)
@@ -313,7 +331,8 @@ void AppWin::open(Glib::RefPtr<Gio::File> const &file)
         std::string errmsg{};
         try
         {
-            editor->set_map(loadAnyMapFile(file));
+            editor->set_map(loadAnyMapFile(file, _cache_write));
+            _document_path = file->get_path();
             return;
         }
         catch (RMF::LoadError const &e)
@@ -338,13 +357,23 @@ void AppWin::open(Glib::RefPtr<Gio::File> const &file)
     else
     {
         editor->set_map(Editor::World::create());
+        _document_path.clear();
     }
 }
 
 void AppWin::save(std::string const &filename)
 {
-    std::ofstream out{filename};
-    MAP::save(out, *editor->get_map().get());
+    if (has_extension(filename, ".rmf"))
+    {
+        std::ofstream out{filename, std::ios::out | std::ios::binary};
+        RMF::save(out, *editor->get_map().get());
+    }
+    else
+    {
+        std::ofstream out{filename};
+        editor->get_map()->write_map(out);
+    }
+    _document_path = filename;
 }
 
 void AppWin::show_console_window()
@@ -498,6 +527,59 @@ void AppWin::_on_opsearch_op_chosen(Editor::Operation const &op)
     _maptool_config.set_operation(op);
 }
 
+void AppWin::_on_autosave_interval_changed()
+{
+    _conn_autosave_timeout.disconnect();
+    auto const interval = _settings->get_uint("autosave-interval");
+    if (interval != 0)
+    {
+        _conn_autosave_timeout = Glib::signal_timeout().connect_seconds(
+            sigc::mem_fun(*this, &AppWin::_on_autosave_timeout),
+            interval);
+    }
+}
+
+bool AppWin::_on_autosave_timeout()
+{
+    auto const world = editor->get_map();
+    if (!world)
+    {
+        return true;
+    }
+
+    auto const dir = std::filesystem::path{Glib::get_user_data_dir()}
+                   / "sickle";
+    std::error_code ec{};
+    std::filesystem::create_directories(dir, ec);
+    auto const path = (dir / _autosave_name()).string();
+
+    auto const elapsed = _autosaver.save(world, path);
+    g_info(
+        "Autosaving to %s, %.3f ms on the main thread",
+        path.c_str(),
+        std::chrono::duration<double, std::milli>{elapsed}.count());
+    return true;
+}
+
+std::string AppWin::_autosave_name() const
+{
+    // Each document gets its own autosave, so windows don't overwrite each
+    // other's. Saved documents are told apart by a hash of their full path,
+    // since different folders often hold maps with the same name.
+    if (_document_path.empty())
+    {
+        return "untitled-" + std::to_string(get_id()) + ".map";
+    }
+    std::filesystem::path const path{_document_path};
+    std::error_code ec{};
+    auto const absolute = std::filesystem::absolute(path, ec);
+    auto const hash = std::hash<std::string>{}(
+        (ec ? path : absolute).lexically_normal().string());
+    std::ostringstream name{};
+    name << path.stem().string() << '-' << std::hex << hash << ".map";
+    return name.str();
+}
+
 void AppWin::_sync_property_editor()
 {
     auto const entity = editor->selected.get_latest_of_type<Editor::Entity>();
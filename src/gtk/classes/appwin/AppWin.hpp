@@ -35,8 +35,10 @@
 #include <config/appid.hpp>
 #include <editor/core/Editor.hpp>
 #include <editor/operations/Operation.hpp>
+#include <editor/world/Autosaver.hpp>
 #include <se-lua/utils/Referenceable.hpp>
 
+#include <giomm/settings.h>
 #include <glibmm/binding.h>
 #include <glibmm/property.h>
 #include <gtkmm/applicationwindow.h>
@@ -51,6 +53,7 @@
 #include <gtkmm/stackswitcher.h>
 
 #include <functional>
+#include <future>
 
 namespace Sickle::AppWin
 {
@@ -67,7 +70,7 @@ namespace Sickle::AppWin
 
         /** Open a file. */
         void open(Glib::RefPtr<Gio::File> const &file);
-        /** Save currently edited map. */
+        /** Save currently edited map. .rmf filenames are saved as RMF. */
         void save(std::string const &filename);
         /** Open the Lua console window. */
         void show_console_window();
@@ -159,6 +162,14 @@ namespace Sickle::AppWin
         Glib::RefPtr<Glib::Binding> _binding_views_vertical_half_position;
         sigc::signal<void()> _sig_lua_reloaded{};
 
+        Glib::RefPtr<Gio::Settings> _settings;
+        Editor::Autosaver _autosaver{};
+        sigc::connection _conn_autosave_timeout{};
+        /** Writes the world cache after an uncached open. */
+        std::future<void> _cache_write{};
+        /** Path the map was opened from or last saved to, if any. */
+        std::string _document_path{};
+
         std::vector<std::string> const _internal_scripts{
             "lua/gdkevents.lua",
             "lua/gdkkeysyms.lua",
@@ -169,6 +180,9 @@ namespace Sickle::AppWin
 
         void _on_grid_size_changed();
         void _on_opsearch_op_chosen(Editor::Operation const &op);
+        void _on_autosave_interval_changed();
+        bool _on_autosave_timeout();
+        std::string _autosave_name() const;
 
         void _sync_property_editor();
 
@@ -21,6 +21,29 @@
 #include <gtk/classes/textureselector/TextureSelector.hpp>
 
 using namespace Sickle::AppWin;
+using Sickle::Editor::Textures::TextureId;
+
+static bool texture_to_text(unsigned int const &texture, Glib::ustring &text)
+{
+    text = TextureId::from_index(texture).name();
+    return true;
+}
+
+/**
+ * Only names which are already known update the face while typing, so
+ * partial names aren't interned. Other names are committed by
+ * FaceEditor::on_texture_entry_commit().
+ */
+static bool text_to_texture(Glib::ustring const &text, unsigned int &texture)
+{
+    auto const id = TextureId::find(text.raw());
+    if (!id)
+    {
+        return false;
+    }
+    texture = id->index();
+    return true;
+}
 
 FaceEditor::FaceEditor(Editor::EditorRef const &editor)
 : Glib::ObjectBase{typeid(FaceEditor)}
@@ -62,6 +85,14 @@ FaceEditor::FaceEditor(Editor::EditorRef const &editor)
 
     _texture_entry.signal_icon_press().connect(
         sigc::mem_fun(*this, &FaceEditor::on_texture_selector_button_clicked));
+    _texture_entry.signal_activate().connect(
+        sigc::mem_fun(*this, &FaceEditor::on_texture_entry_commit));
+    _texture_entry.signal_focus_out_event().connect(
+        [this](GdkEventFocus *)
+        {
+            on_texture_entry_commit();
+            return false;
+        });
 }
 
 void FaceEditor::set_face(Editor::FaceRef const &face)
@@ -97,11 +128,13 @@ void FaceEditor::on_face_changed()
         return;
     }
 
-    _bind_texture = Glib::Binding::bind_property(
+    _bind_texture = Glib::Binding::bind_property<unsigned int, Glib::ustring>(
         face->property_texture(),
         _texture_entry.property_text(),
         Glib::BindingFlags::BINDING_SYNC_CREATE
-            | Glib::BindingFlags::BINDING_BIDIRECTIONAL);
+            | Glib::BindingFlags::BINDING_BIDIRECTIONAL,
+        sigc::ptr_fun(&texture_to_text),
+        sigc::ptr_fun(&text_to_texture));
 
     _bind_u = Glib::Binding::bind_property(
         face->property_u(),
@@ -134,6 +167,20 @@ void FaceEditor::on_face_changed()
             | Glib::BindingFlags::BINDING_BIDIRECTIONAL);
 }
 
+void FaceEditor::on_texture_entry_commit()
+{
+    auto const &face = get_face();
+    if (!face)
+    {
+        return;
+    }
+    TextureId const texture{_texture_entry.get_text().raw()};
+    if (texture != face->get_texture())
+    {
+        face->set_texture(texture);
+    }
+}
+
 void FaceEditor::on_texture_selector_button_clicked(
     Gtk::EntryIconPosition const &icon_pos,
     GdkEventButton const *button)
@@ -152,6 +199,6 @@ void FaceEditor::show_texture_select_window()
     if (result == Gtk::RESPONSE_ACCEPT)
     {
         auto const tex = texture_selector->get_selected_texture();
-        get_face()->set_texture(tex);
+        get_face()->set_texture(TextureId{tex});
     }
 }
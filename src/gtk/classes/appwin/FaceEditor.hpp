@@ -135,6 +135,7 @@ namespace Sickle::AppWin
 
     protected:
         void on_face_changed();
+        void on_texture_entry_commit();
         void on_texture_selector_button_clicked(
             Gtk::EntryIconPosition const &icon_pos,
             GdkEventButton const *button);
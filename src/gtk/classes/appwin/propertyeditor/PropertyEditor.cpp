@@ -19,6 +19,8 @@
 #include "PropertyEditor.hpp"
 #include "CellRendererProperty.hpp"
 
+#include <unordered_set>
+
 using namespace Sickle::AppWin;
 
 static Glib::ustring generate_tooltip(
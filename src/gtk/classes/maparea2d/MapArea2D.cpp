@@ -381,6 +381,11 @@ void Sickle::MapArea2D::on_editor_map_changed()
     static auto const on_entity_added
         = [](Editor::EditorObjectRef const &obj) -> void
     {
+        if (!Editor::EntityRef::cast_dynamic(obj))
+        {
+            // Groups are drawn through their members.
+            return;
+        }
         obj->add_component(World2D::DrawComponentFactory{}.construct(obj));
         obj->add_component(World2D::BBoxComponentFactory{}.construct(obj));
 
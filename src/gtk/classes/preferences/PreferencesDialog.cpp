@@ -42,6 +42,11 @@ PreferencesDialog::PreferencesDialog(Gtk::Window &parent)
     _sprite_path_entry.property_secondary_icon_name() = "folder";
     _sprite_path_entry.property_secondary_icon_activatable() = true;
 
+    _autosave_spin.set_range(0, 24 * 60 * 60);
+    _autosave_spin.set_increments(30, 300);
+    _autosave_spin.set_value(_settings->get_uint("autosave-interval"));
+    _autosave_spin.set_tooltip_text("0 disables autosaving");
+
     auto const wad_paths = _settings->get_string_array("wad-paths");
     _wads.property_wad_paths().set_value(
         std::set<Glib::ustring>(wad_paths.begin(), wad_paths.end()));
@@ -55,7 +60,10 @@ PreferencesDialog::PreferencesDialog(Gtk::Window &parent)
     _grid.attach(_sprite_path_label, 0, 2);
     _grid.attach(_sprite_path_entry, 1, 2);
 
-    _grid.attach(_wads, 0, 3, 2);
+    _grid.attach(_autosave_label, 0, 3);
+    _grid.attach(_autosave_spin, 1, 3);
+
+    _grid.attach(_wads, 0, 4, 2);
 
     add_button("Cancel", Gtk::ResponseType::RESPONSE_CANCEL);
     add_button("Confirm", Gtk::ResponseType::RESPONSE_ACCEPT);
@@ -90,6 +98,9 @@ void PreferencesDialog::_apply_preferences()
     _settings->set_string("fgd-path", _gamedef_entry.get_text());
     _settings->set_string("game-root-path", _game_path_entry.get_text());
     _settings->set_string("sprite-root-path", _sprite_path_entry.get_text());
+    _settings->set_uint(
+        "autosave-interval",
+        static_cast<guint>(_autosave_spin.get_value_as_int()));
     _settings->set_string_array(
         "wad-paths",
         _wads.property_wad_paths().get_value());
@@ -26,6 +26,7 @@
 #include <gtkmm/entry.h>
 #include <gtkmm/grid.h>
 #include <gtkmm/label.h>
+#include <gtkmm/spinbutton.h>
 
 namespace Sickle
 {
@@ -53,6 +54,8 @@ namespace Sickle
         Gtk::Entry _game_path_entry{};
         Gtk::Label _sprite_path_label{"Sprite Root Path"};
         Gtk::Entry _sprite_path_entry{};
+        Gtk::Label _autosave_label{"Autosave Interval (seconds)"};
+        Gtk::SpinButton _autosave_spin{};
         WADList _wads{};
 
         void _apply_preferences();
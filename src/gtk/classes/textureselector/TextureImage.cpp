@@ -24,21 +24,23 @@ using namespace Sickle::TextureSelector;
 
 TextureImage::TextureImage(
     std::shared_ptr<Editor::Textures::TextureInfo> const &texinfo,
-    std::shared_ptr<uint8_t[]> const &pixels)
+    Editor::Textures::Thumbnail const &thumbnail)
 : Glib::ObjectBase{typeid(TextureImage)}
 , Gtk::Box{Gtk::Orientation::ORIENTATION_VERTICAL}
 , _texinfo{texinfo}
-, _pixels{pixels}
+, _pixels{thumbnail.pixels}
 , _label{_texinfo->get_name()}
 {
+    // The Pixbuf only reads the pixels, which may be in the read-only
+    // thumbnail pack.
     auto const pixbuf = Gdk::Pixbuf::create_from_data(
-        _pixels.get(),
+        const_cast<uint8_t *>(_pixels.get()),
         Gdk::Colorspace::COLORSPACE_RGB,
         false,
         8,
-        _texinfo->get_width(),
-        _texinfo->get_height(),
-        _texinfo->get_width() * 3);
+        thumbnail.width,
+        thumbnail.height,
+        thumbnail.width * 3);
     _image = Gtk::Image{pixbuf};
 
     add(_image);
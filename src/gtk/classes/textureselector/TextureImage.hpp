@@ -20,6 +20,7 @@
 #define SE_TEXTURESELECTOR_TEXTUREIMAGE_HPP
 
 #include <editor/textures/TextureInfo.hpp>
+#include <editor/textures/ThumbnailCache.hpp>
 
 #include <gtkmm/box.h>
 #include <gtkmm/image.h>
@@ -37,7 +38,7 @@ namespace Sickle::TextureSelector
     public:
         TextureImage(
             std::shared_ptr<Editor::Textures::TextureInfo> const &texinfo,
-            std::shared_ptr<uint8_t[]> const &pixels);
+            Editor::Textures::Thumbnail const &thumbnail);
         virtual ~TextureImage() = default;
 
         /**
@@ -50,7 +51,7 @@ namespace Sickle::TextureSelector
     private:
         std::shared_ptr<Editor::Textures::TextureInfo> _texinfo{nullptr};
         // Image's Pixbuf needs the data buffer to stay alive.
-        std::shared_ptr<uint8_t[]> _pixels{nullptr};
+        std::shared_ptr<uint8_t const[]> _pixels{nullptr};
 
         Gtk::Image _image;
         Gtk::Label _label;
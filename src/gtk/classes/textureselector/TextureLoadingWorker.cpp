@@ -26,20 +26,27 @@ using namespace Sickle::TextureSelector;
 void TextureLoadingWorker::do_work(Glib::Dispatcher *dispatcher)
 {
     auto &texman = Editor::Textures::TextureManager::get_reference();
+    Editor::Textures::ThumbnailCache cache{};
+    bool cancelled = false;
     for (auto const &texinfo : texman.get_textures())
     {
-        auto const pixels = texinfo->load_rgb();
+        auto const thumbnail = cache.get(*texinfo);
         {
             std::lock_guard lock{_mutex};
-            _results.push_back(std::make_pair(texinfo, pixels));
-            if (_cancelled)
-            {
-                break;
-            }
+            _results.push_back(std::make_pair(texinfo, thumbnail));
+            cancelled = _cancelled;
+        }
+        if (cancelled)
+        {
+            break;
         }
         dispatcher->emit();
     }
 
+    // Saving only adds to the pack, so a cancelled run can keep what it
+    // made too.
+    cache.save();
+
     {
         std::lock_guard lock{_mutex};
         _is_done = true;
@@ -21,6 +21,7 @@
 #define SE_APPWIN_TEXTURELOADINGWORKER_HPP
 
 #include <editor/textures/TextureInfo.hpp>
+#include <editor/textures/ThumbnailCache.hpp>
 
 #include <glibmm/dispatcher.h>
 
@@ -32,14 +33,15 @@
 namespace Sickle::TextureSelector
 {
     /**
-     * Worker to load all the textures from the TextureManager in RGB format.
+     * Worker to load thumbnails of all the textures from the TextureManager.
+     * Thumbnails come from the ThumbnailCache where possible.
      */
     class TextureLoadingWorker
     {
     public:
         using Result = std::pair<
             std::shared_ptr<Editor::Textures::TextureInfo>,
-            std::shared_ptr<uint8_t[]>>;
+            Editor::Textures::Thumbnail>;
 
         /**
          * The main work function. Loads all the textures from TextureManager
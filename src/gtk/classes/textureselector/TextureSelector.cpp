@@ -23,6 +23,8 @@
 
 #include <gtkmm/builder.h>
 
+#include <utility>
+
 using namespace Sickle::TextureSelector;
 
 Glib::RefPtr<TextureSelector> TextureSelector::create()
@@ -50,7 +52,6 @@ TextureSelector::TextureSelector()
     _wad_filter->property_active().signal_changed().connect(
         sigc::mem_fun(*this, &TextureSelector::on_wad_filter_changed));
 
-    _flow->set_filter_func(sigc::mem_fun(*this, &TextureSelector::filter_func));
     _flow->set_sort_func(sigc::mem_fun(*this, &TextureSelector::sort_func));
 
     _cancel->signal_clicked().connect(
@@ -109,12 +110,12 @@ void TextureSelector::on_wads_changed()
 
 void TextureSelector::on_search_changed()
 {
-    _flow->invalidate_filter();
+    _update_matches();
 }
 
 void TextureSelector::on_wad_filter_changed()
 {
-    _flow->invalidate_filter();
+    _update_matches();
 }
 
 void TextureSelector::on_TextureManager_wads_changed()
@@ -122,31 +123,6 @@ void TextureSelector::on_TextureManager_wads_changed()
     _refresh_textures();
 }
 
-bool TextureSelector::filter_func(Gtk::FlowBoxChild const *child) const
-{
-    auto const image = dynamic_cast<TextureImage const *>(child->get_child());
-    auto const &texinfo = image->get_info();
-
-    // Exclude textures not in filtered WAD. Special value "*" skips this check.
-    auto const filter_wad = _wad_filter->get_active_text();
-    Glib::ustring const source_wad{texinfo->get_source_wad()};
-    if (filter_wad != "*" && filter_wad != source_wad)
-    {
-        return false;
-    }
-
-    auto const search = _search->get_text();
-    Glib::ustring const name{texinfo->get_name()};
-
-    // Search behaviour: Filter in any textures whose name includes SEARCH as a
-    // substring, ignoring case.
-    auto const search_cmp = search.casefold();
-    auto const name_cmp = name.casefold();
-
-    auto const it = name_cmp.find(search_cmp);
-    return it != Glib::ustring::npos;
-}
-
 int TextureSelector::sort_func(
     Gtk::FlowBoxChild const *a,
     Gtk::FlowBoxChild const *b) const
@@ -173,6 +149,8 @@ void TextureSelector::_refresh_textures()
     {
         _wad_filter->append(wad_name);
     }
+    _index.rebuild(texman.get_textures());
+    _update_matches();
     _add_textures();
 }
 
@@ -183,6 +161,7 @@ void TextureSelector::_clear_textures()
         _flow->remove(*img);
     }
     _images.clear();
+    _children.clear();
 }
 
 void TextureSelector::_add_textures()
@@ -195,12 +174,19 @@ void TextureSelector::_on_worker_notify()
 {
     auto const results = _worker.get_results();
 
-    for (auto const &[texinfo, pixels] : results)
+    for (auto const &[texinfo, thumbnail] : results)
     {
-        auto const image = std::make_shared<TextureImage>(texinfo, pixels);
+        auto const image = std::make_shared<TextureImage>(texinfo, thumbnail);
         _images.push_back(image);
         _flow->add(*image);
         image->show_all();
+
+        // The FlowBox wraps each image in a child, which is shown or hidden
+        // to filter it. Stop Dialog::show_all() from showing it again.
+        auto const child = image->get_parent();
+        _children.emplace(texinfo.get(), child);
+        child->set_no_show_all(true);
+        child->set_visible(_matches.count(texinfo.get()) != 0);
     }
 
     if (_worker_thread && _worker.is_done())
@@ -212,3 +198,33 @@ void TextureSelector::_on_worker_notify()
         _worker_thread.reset();
     }
 }
+
+void TextureSelector::_update_matches()
+{
+    // Special value "*" matches every WAD.
+    auto filter_wad = _wad_filter->get_active_text();
+    if (filter_wad == "*")
+    {
+        filter_wad.clear();
+    }
+    auto matches = _index.search(_search->get_text().raw(), filter_wad);
+
+    // Only touch the children whose visibility changes.
+    for (auto const texinfo : _matches)
+    {
+        auto const it = _children.find(texinfo);
+        if (it != _children.end() && !matches.count(texinfo))
+        {
+            it->second->hide();
+        }
+    }
+    for (auto const texinfo : matches)
+    {
+        auto const it = _children.find(texinfo);
+        if (it != _children.end() && !_matches.count(texinfo))
+        {
+            it->second->show();
+        }
+    }
+    _matches = std::move(matches);
+}
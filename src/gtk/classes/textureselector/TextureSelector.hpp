@@ -22,6 +22,8 @@
 #include "TextureImage.hpp"
 #include "TextureLoadingWorker.hpp"
 
+#include <editor/textures/TextureSearchIndex.hpp>
+
 #include <glibmm/dispatcher.h>
 #include <glibmm/property.h>
 #include <glibmm/refptr.h>
@@ -33,12 +35,17 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace Sickle::TextureSelector
 {
     /**
      * Allows the user to select a texture from available WAD files.
+     *
+     * Searching uses a TextureSearchIndex, and only the textures entering or
+     * leaving the set of matches are shown or hidden.
      */
     class TextureSelector : public Glib::Object
     {
@@ -76,7 +83,6 @@ namespace Sickle::TextureSelector
 
         void on_TextureManager_wads_changed();
 
-        bool filter_func(Gtk::FlowBoxChild const *child) const;
         int sort_func(Gtk::FlowBoxChild const *a, Gtk::FlowBoxChild const *b)
             const;
 
@@ -89,6 +95,11 @@ namespace Sickle::TextureSelector
         Gtk::Button *_confirm{nullptr};
 
         std::vector<std::shared_ptr<TextureImage>> _images{};
+        std::unordered_map<Editor::Textures::TextureInfo const *, Gtk::Widget *>
+            _children{};
+
+        Editor::Textures::TextureSearchIndex _index{};
+        std::unordered_set<Editor::Textures::TextureInfo const *> _matches{};
 
         Glib::Dispatcher _dispatcher{};
         TextureLoadingWorker _worker{};
@@ -99,6 +110,7 @@ namespace Sickle::TextureSelector
         void _refresh_textures();
         void _clear_textures();
         void _add_textures();
+        void _update_matches();
 
         void _on_worker_notify();
     };
@@ -22,6 +22,7 @@
 #include <editor/lua/Editor_Lua.hpp>
 #include <se-lua/lua-geo/LuaGeo.hpp>
 #include <se-lua/utils/RefBuilder.hpp>
+#include <world3d/Texture.hpp>
 
 #define METATABLE "Sickle.gtk.maparea3d"
 
@@ -150,6 +151,28 @@ static int set_wireframe(lua_State *L)
     return 0;
 }
 
+static int get_texture_stats(lua_State *L)
+{
+    lmaparea3d_check(L, 1);
+    auto const stats = World3D::Texture::budget().get_stats();
+    lua_newtable(L);
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.resident_bytes));
+    lua_setfield(L, -2, "resident_bytes");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.budget));
+    lua_setfield(L, -2, "budget");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.resident));
+    lua_setfield(L, -2, "resident");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.referenced));
+    lua_setfield(L, -2, "referenced");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.hits));
+    lua_setfield(L, -2, "hits");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.misses));
+    lua_setfield(L, -2, "misses");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.evictions));
+    lua_setfield(L, -2, "evictions");
+    return 1;
+}
+
 static int do_nothing(lua_State *L)
 {
     return 0;
@@ -164,6 +187,7 @@ static luaL_Reg methods[] = {
     {  "get_mouse_sensitivity",  get_mouse_sensitivity},
     {   "get_shift_multiplier",   get_shift_multiplier},
     {              "get_state",              get_state},
+    {      "get_texture_stats",      get_texture_stats},
     // {"get_transform", get_transform},
     {          "get_wireframe",          get_wireframe},
 
@@ -0,0 +1,45 @@
+/**
+ * Filesystem.hpp - Path utilities.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_FILESYSTEM_HPP
+#define SE_FILESYSTEM_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <string>
+
+/**
+ * Check if PATH ends with extension EXT, ignoring case.
+ *
+ * @param path The path to check.
+ * @param ext The extension, lowercase and including the dot.
+ * @return Whether PATH has the extension.
+ */
+inline bool has_extension(std::string const &path, std::string const &ext)
+{
+    auto actual = std::filesystem::path{path}.extension().string();
+    std::transform(
+        actual.begin(),
+        actual.end(),
+        actual.begin(),
+        [](unsigned char ch) { return std::tolower(ch); });
+    return actual == ext;
+}
+
+#endif
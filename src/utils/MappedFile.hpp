@@ -0,0 +1,213 @@
+/**
+ * MappedFile.hpp - Read-only memory-mapped files.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_MAPPEDFILE_HPP
+#define SE_MAPPEDFILE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * A whole file mapped read-only into memory. The contents are paged in by the
+ * OS as they are touched, so opening even a very large file is cheap.
+ */
+class MappedFile
+{
+public:
+    /** How the file will be read, so the OS can page it in efficiently. */
+    enum class Access
+    {
+        /** Front to back. Pages are read ahead aggressively. */
+        SEQUENTIAL,
+        /** In no particular order. Only touched pages are read. */
+        RANDOM,
+    };
+
+    MappedFile() = default;
+
+    /**
+     * Map the file at PATH.
+     *
+     * @throw std::runtime_error if the file can't be opened or mapped.
+     */
+    explicit MappedFile(
+        std::string const &path,
+        Access access = Access::SEQUENTIAL)
+    {
+#ifdef _WIN32
+        auto const file = CreateFileA(
+            path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL
+                | (access == Access::SEQUENTIAL ? FILE_FLAG_SEQUENTIAL_SCAN
+                                                : FILE_FLAG_RANDOM_ACCESS),
+            nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error{"failed to open '" + path + "'"};
+        }
+        LARGE_INTEGER size{};
+        GetFileSizeEx(file, &size);
+        _size = static_cast<size_t>(size.QuadPart);
+        if (_size != 0)
+        {
+            auto const mapping = CreateFileMappingA(
+                file,
+                nullptr,
+                PAGE_READONLY,
+                0,
+                0,
+                nullptr);
+            if (mapping)
+            {
+                _data = static_cast<char const *>(
+                    MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+#else
+        auto const fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+        {
+            throw std::runtime_error{"failed to open '" + path + "'"};
+        }
+        struct stat info{};
+        fstat(fd, &info);
+        _size = static_cast<size_t>(info.st_size);
+        if (_size != 0)
+        {
+            auto const ptr
+                = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (ptr != MAP_FAILED)
+            {
+                _data = static_cast<char const *>(ptr);
+                madvise(
+                    ptr,
+                    _size,
+                    access == Access::SEQUENTIAL ? MADV_SEQUENTIAL
+                                                 : MADV_RANDOM);
+            }
+        }
+        close(fd);
+#endif
+        if (_size != 0 && !_data)
+        {
+            throw std::runtime_error{"failed to map '" + path + "'"};
+        }
+    }
+
+    MappedFile(MappedFile const &) = delete;
+    MappedFile &operator=(MappedFile const &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept
+    : _data{std::exchange(other._data, nullptr)}
+    , _size{std::exchange(other._size, 0)}
+    {
+    }
+
+    MappedFile &operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            _unmap();
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile() { _unmap(); }
+
+    /** Pointer to the file contents. Null if the file is empty. */
+    char const *data() const { return _data; }
+
+    /** Size of the file in bytes. */
+    size_t size() const { return _size; }
+
+    /** The file contents as a string. */
+    std::string_view view() const { return {_data, _size}; }
+
+    /**
+     * Drop pages in a range from memory. They stay mapped, and are read back
+     * from the file if touched again. Only a hint, it may do nothing.
+     *
+     * @param offset Start of the range.
+     * @param size Length of the range.
+     */
+    void discard(size_t offset, size_t size) const
+    {
+        if (!_data || offset >= _size)
+        {
+            return;
+        }
+        size = std::min(size, _size - offset);
+#ifndef _WIN32
+        // madvise() needs a page-aligned start.
+        auto const page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        auto const start = offset - offset % page;
+        madvise(
+            const_cast<char *>(_data) + start,
+            size + (offset - start),
+            MADV_DONTNEED);
+#endif
+    }
+
+private:
+    char const *_data{nullptr};
+    size_t _size{0};
+
+    void _unmap()
+    {
+        if (!_data)
+        {
+            return;
+        }
+#ifdef _WIN32
+        UnmapViewOfFile(_data);
+#else
+        munmap(const_cast<char *>(_data), _size);
+#endif
+        _data = nullptr;
+        _size = 0;
+    }
+};
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ * ParallelFor.hpp - Run a loop body across multiple threads.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_PARALLELFOR_HPP
+#define SE_PARALLELFOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Call `body(i)` for each i in [0, count), spread across a pool of worker
+ * threads. Blocks until every call has finished. Indices are handed out one
+ * at a time, so uneven workloads still balance out.
+ *
+ * If any call throws, the remaining indices are skipped and the first
+ * exception is rethrown on the calling thread.
+ *
+ * @param count Number of iterations.
+ * @param body Callable taking a size_t index. Must be safe to call from
+ *             multiple threads at once.
+ * @param max_threads Upper bound on the number of threads to use. 0 means
+ *                    use all hardware threads.
+ */
+template<class Body>
+void parallel_for(size_t count, Body const &body, size_t max_threads = 0)
+{
+    size_t threads = std::thread::hardware_concurrency();
+    if (max_threads != 0)
+    {
+        threads = std::min(threads, max_threads);
+    }
+    threads = std::min(std::max<size_t>(threads, 1), count);
+
+    // Not worth spinning up threads for.
+    if (threads <= 1)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            body(i);
+        }
+        return;
+    }
+
+    std::atomic_size_t next{0};
+    std::exception_ptr error{nullptr};
+    std::mutex error_mutex{};
+
+    auto const worker = [&]()
+    {
+        for (size_t i = next++; i < count; i = next++)
+        {
+            try
+            {
+                body(i);
+            }
+            catch (...)
+            {
+                std::lock_guard lock{error_mutex};
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+                next = count;
+            }
+        }
+    };
+
+    // The calling thread does its share of the work too.
+    std::vector<std::thread> pool{};
+    pool.reserve(threads - 1);
+    for (size_t t = 0; t < threads - 1; ++t)
+    {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : pool)
+    {
+        thread.join();
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+#endif
@@ -160,6 +160,6 @@ void World3D::Face::_sync_texture()
     {
         return;
     }
-    _texture = Texture::create_for_name(_src->get_texture());
+    _texture = Texture::acquire(_src->get_texture());
     _sync_vertices();
 }
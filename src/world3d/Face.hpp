@@ -151,6 +151,7 @@ namespace World3D
         Sickle::Editor::FaceRef _src{};
         GLint _offset;
         float const _starting_rotation;
+        // Holds a reference to the texture in Texture::budget().
         std::shared_ptr<Texture> _texture{nullptr};
         std::vector<Vertex> _vertices{};
 
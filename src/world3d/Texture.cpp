@@ -20,6 +20,16 @@
 
 #include <editor/textures/TextureManager.hpp>
 
+#include <vector>
+
+/** Mipmap levels uploaded for each texture. */
+static Sickle::Editor::Textures::MipmapLevel const MIPMAPS[] = {
+    Sickle::Editor::Textures::MipmapLevel::MIPMAP_FULL,
+    Sickle::Editor::Textures::MipmapLevel::MIPMAP_HALF,
+    Sickle::Editor::Textures::MipmapLevel::MIPMAP_QUARTER,
+    Sickle::Editor::Textures::MipmapLevel::MIPMAP_EIGHTH,
+};
+
 /** Create a GLUtil::Texture shared_ptr. */
 static auto make_texture(std::string const &name)
 {
@@ -37,16 +47,13 @@ static auto make_texture(std::string const &name)
 decltype(World3D::Texture::texture) World3D::Texture::
     make_gltexture_for_texinfo(TexInfo const &texinfo)
 {
-    static std::vector const MIPMAPS{
-        Sickle::Editor::Textures::MipmapLevel::MIPMAP_FULL,
-        Sickle::Editor::Textures::MipmapLevel::MIPMAP_HALF,
-        Sickle::Editor::Textures::MipmapLevel::MIPMAP_QUARTER,
-        Sickle::Editor::Textures::MipmapLevel::MIPMAP_EIGHTH,
-    };
-
     auto const texture = make_texture(texinfo->get_name());
+    // Every mipmap is smaller than the full size one, so one buffer does.
+    std::vector<uint8_t> pixels(
+        4 * texinfo->get_width(MIPMAPS[0]) * texinfo->get_height(MIPMAPS[0]));
     for (auto const mipmap : MIPMAPS)
     {
+        texinfo->load_rgba(pixels.data(), mipmap);
         glTexImage2D(
             texture->type(),
             static_cast<GLint>(mipmap),
@@ -56,7 +63,7 @@ decltype(World3D::Texture::texture) World3D::Texture::
             0,
             GL_RGBA,
             GL_UNSIGNED_BYTE,
-            texinfo->load_rgba(mipmap).get());
+            pixels.data());
     }
     texture->unbind();
     return texture;
@@ -120,16 +127,16 @@ std::shared_ptr<World3D::Texture> World3D::Texture::make_missing_texture()
     return missing;
 }
 
-std::shared_ptr<World3D::Texture> World3D::Texture::create_for_name(
-    std::string const &texture_name)
+std::shared_ptr<World3D::Texture> World3D::Texture::acquire(
+    Sickle::Editor::Textures::TextureId texture_id)
 {
     auto &texman = Sickle::Editor::Textures::TextureManager::get_reference();
     TexInfo texinfo{nullptr};
 
-    // Get texture info for the named texture.
+    // Get texture info for the texture.
     try
     {
-        texinfo = texman.get_texture(texture_name);
+        texinfo = texman.get_texture(texture_id);
     }
     // If this fails, the texture doesn't exist. Return missing texture.
     catch (std::out_of_range const &)
@@ -137,17 +144,33 @@ std::shared_ptr<World3D::Texture> World3D::Texture::create_for_name(
         return make_missing_texture();
     }
 
-    // Try to get cached texture.
-    try
-    {
-        return texinfo->get_cached<Texture>();
-    }
-    catch (std::out_of_range const &)
+    // Textures are keyed by TextureInfo rather than ID, so replacing a WAD
+    // doesn't reuse textures from the old one.
+    auto &the_budget = budget();
+    auto texture = std::static_pointer_cast<Texture>(
+        the_budget.acquire(texinfo.get()));
+    if (!texture)
     {
+        texture.reset(new Texture{texinfo});
+        size_t bytes = 0;
+        for (auto const mipmap : MIPMAPS)
+        {
+            bytes += 4 * texinfo->get_width(mipmap)
+                   * texinfo->get_height(mipmap);
+        }
+        the_budget.insert(texinfo, texture, bytes);
     }
 
-    // Texture isn't cached, we have to create (and cache) it.
-    std::shared_ptr<Texture> texture{new Texture{texinfo}};
-    texinfo->cache_object(texture);
-    return texture;
+    // Share ownership with the resident texture, and release the reference
+    // once the last copy goes.
+    auto const source = texinfo.get();
+    return std::shared_ptr<Texture>{
+        texture.get(),
+        [texture, source](Texture *) { budget().release(source); }};
+}
+
+World3D::TextureBudget &World3D::Texture::budget()
+{
+    static TextureBudget the_budget{};
+    return the_budget;
 }
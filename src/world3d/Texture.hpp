@@ -20,6 +20,7 @@
 #define SE_WORLD3D_TEXTURE_HPP
 
 #include "DeferredExec.hpp"
+#include "TextureBudget.hpp"
 
 #include <editor/textures/TextureInfo.hpp>
 #include <glutils/glutils.hpp>
@@ -43,12 +44,21 @@ namespace World3D
         static std::shared_ptr<Texture> make_missing_texture();
 
         /**
-         * Create a texture object for the named texture.
+         * Get a texture object for the texture with the given ID, uploading
+         * it if it isn't resident. The result holds a reference to the
+         * texture in budget(), which is dropped once every copy of the
+         * result is destroyed.
          *
          * @warning Requires an active OpenGL context.
          */
-        static std::shared_ptr<Texture> create_for_name(
-            std::string const &texture_name);
+        static std::shared_ptr<Texture> acquire(
+            Sickle::Editor::Textures::TextureId texture_id);
+
+        /**
+         * Get the budget tracking which textures are resident on the GPU.
+         * Doesn't include the "Missing Texture" texture.
+         */
+        static TextureBudget &budget();
 
     protected:
         using TexInfo = std::shared_ptr<Sickle::Editor::Textures::TextureInfo>;
@@ -0,0 +1,103 @@
+/**
+ * TextureBudget.cpp - GPU texture memory accounting.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TextureBudget.hpp"
+
+#include <stdexcept>
+
+World3D::TextureBudget::TextureBudget(size_t budget)
+{
+    _stats.budget = budget;
+}
+
+std::shared_ptr<void> World3D::TextureBudget::acquire(void const *source)
+{
+    auto const it = _residents.find(source);
+    if (it == _residents.end())
+    {
+        ++_stats.misses;
+        return nullptr;
+    }
+    ++_stats.hits;
+
+    auto &resident = it->second;
+    if (resident.references++ == 0)
+    {
+        _unreferenced.erase(resident.lru_position);
+        ++_stats.referenced;
+    }
+    return resident.texture;
+}
+
+void World3D::TextureBudget::insert(
+    std::shared_ptr<void const> const &source,
+    std::shared_ptr<void> const &texture,
+    size_t bytes)
+{
+    auto const [it, inserted] = _residents.try_emplace(
+        source.get(),
+        Resident{source, texture, bytes, 1, {}});
+    if (!inserted)
+    {
+        throw std::logic_error{"texture is already resident"};
+    }
+    _stats.resident_bytes += bytes;
+    ++_stats.resident;
+    ++_stats.referenced;
+    trim();
+}
+
+void World3D::TextureBudget::release(void const *source)
+{
+    auto const it = _residents.find(source);
+    if (it == _residents.end() || it->second.references == 0)
+    {
+        throw std::logic_error{"texture released too many times"};
+    }
+
+    auto &resident = it->second;
+    if (--resident.references == 0)
+    {
+        _unreferenced.push_front(source);
+        resident.lru_position = _unreferenced.begin();
+        --_stats.referenced;
+    }
+}
+
+void World3D::TextureBudget::set_budget(size_t bytes)
+{
+    _stats.budget = bytes;
+}
+
+void World3D::TextureBudget::trim()
+{
+    while (_stats.resident_bytes > _stats.budget && !_unreferenced.empty())
+    {
+        auto const it = _residents.find(_unreferenced.back());
+        _stats.resident_bytes -= it->second.bytes;
+        --_stats.resident;
+        ++_stats.evictions;
+        _residents.erase(it);
+        _unreferenced.pop_back();
+    }
+}
+
+World3D::TextureBudget::Stats World3D::TextureBudget::get_stats() const
+{
+    return _stats;
+}
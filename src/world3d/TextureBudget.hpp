@@ -0,0 +1,147 @@
+/**
+ * TextureBudget.hpp - GPU texture memory accounting.
+ * Copyright (C) 2024 Trevor Last
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SE_WORLD3D_TEXTUREBUDGET_HPP
+#define SE_WORLD3D_TEXTUREBUDGET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace World3D
+{
+    /**
+     * Tracks which textures are resident on the GPU, and how much memory
+     * they use.
+     *
+     * Each texture is keyed by its source, and counts how many users have
+     * acquired it. Textures nobody references are kept in least-recently-
+     * released order, and are evicted oldest first whenever resident memory
+     * exceeds the budget. Referenced textures are never evicted, so usage
+     * can go over budget.
+     *
+     * Residents are type-erased, and eviction only drops the budget's
+     * reference to them, so no GL context is needed to use this class.
+     * Eviction only happens in insert() and trim(). When the residents are
+     * GL objects, those must be called with the context current. Not
+     * thread-safe.
+     */
+    class TextureBudget
+    {
+    public:
+        /** Snapshot of the budget's accounting. */
+        struct Stats
+        {
+            /// Bytes used by resident textures.
+            size_t resident_bytes{0};
+            /// The budget, in bytes.
+            size_t budget{0};
+            /// Number of resident textures.
+            size_t resident{0};
+            /// Number of resident textures with at least one reference.
+            size_t referenced{0};
+            /// Number of acquire() calls which found the texture resident.
+            uint64_t hits{0};
+            /// Number of acquire() calls which didn't.
+            uint64_t misses{0};
+            /// Number of textures evicted.
+            uint64_t evictions{0};
+        };
+
+        /** Default budget, in bytes. */
+        static constexpr size_t DEFAULT_BUDGET = 256 * 1024 * 1024;
+
+        explicit TextureBudget(size_t budget = DEFAULT_BUDGET);
+
+        TextureBudget(TextureBudget const &) = delete;
+        TextureBudget &operator=(TextureBudget const &) = delete;
+
+        /**
+         * Reference a resident texture.
+         *
+         * @param source Key the texture was inserted with.
+         * @return The texture, or null if it isn't resident. Each non-null
+         *         result must be balanced by a call to release().
+         */
+        std::shared_ptr<void> acquire(void const *source);
+
+        /**
+         * Make a texture resident, with one reference, then evict textures
+         * until usage is within budget.
+         *
+         * @param source Key for the texture. Kept alive while the texture
+         *               is resident, so the key can't be reused.
+         * @param texture The texture.
+         * @param bytes Memory used by the texture.
+         * @throw std::logic_error if SOURCE is already resident.
+         */
+        void insert(
+            std::shared_ptr<void const> const &source,
+            std::shared_ptr<void> const &texture,
+            size_t bytes);
+
+        /**
+         * Drop a reference to a resident texture. It isn't evicted until
+         * there's memory pressure.
+         *
+         * @param source Key of the texture.
+         * @throw std::logic_error if the texture has no references.
+         */
+        void release(void const *source);
+
+        /**
+         * Set the budget. Textures aren't evicted until the next insert()
+         * or trim().
+         *
+         * @param bytes The new budget, in bytes.
+         */
+        void set_budget(size_t bytes);
+
+        /**
+         * Evict unreferenced textures until usage is within budget.
+         */
+        void trim();
+
+        /**
+         * Get the budget's accounting.
+         *
+         * @return Current statistics.
+         */
+        Stats get_stats() const;
+
+    private:
+        struct Resident
+        {
+            std::shared_ptr<void const> source;
+            std::shared_ptr<void> texture;
+            size_t bytes;
+            size_t references;
+            // Position in _unreferenced, if references is 0.
+            std::list<void const *>::iterator lru_position;
+        };
+
+        std::unordered_map<void const *, Resident> _residents{};
+        // Front is most recently released.
+        std::list<void const *> _unreferenced{};
+        Stats _stats{};
+    };
+} // namespace World3D
+
+#endif